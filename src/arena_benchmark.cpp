@@ -0,0 +1,108 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tensor_arena.hpp"
+#include <scope_guard.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Usage: arena_benchmark [iterations] [huge pages 0|1]
+
+// Time per tensor of `make`, create and delete included, after a first one that may map a slab.
+template <typename F>
+static double Measure(int iterations, F&& make) {
+  auto warmup = make();
+  if (warmup == nullptr) {
+    return -1.0;
+  }
+  TF_DeleteTensor(warmup);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    auto tensor = make();
+    if (tensor == nullptr) {
+      return -1.0;
+    }
+    TF_DeleteTensor(tensor);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(stop - start).count() / iterations;
+}
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000;
+  tf_utils::TensorArenaOptions options;
+  options.huge_pages = argc > 2 && std::atoi(argv[2]) != 0;
+
+  tf_utils::TensorArena arena{options};
+
+  // A deleted tensor's block is the next one handed out for the same size class.
+  const std::vector<std::int64_t> dims = {1, 5, 12};
+  const std::vector<float> vals(60, 0.5f);
+  auto first = arena.CreateTensor(TF_FLOAT, dims, vals);
+  if (first == nullptr || !tf_utils::IsTensorAligned(TF_TensorData(first))) {
+    std::cout << "Arena tensor is not aligned" << std::endl;
+    return 1;
+  }
+  auto first_data = TF_TensorData(first);
+  TF_DeleteTensor(first);
+  auto second = arena.CreateTensor(TF_FLOAT, dims, vals);
+  SCOPE_EXIT{ TF_DeleteTensor(second); };
+  if (second == nullptr || TF_TensorData(second) != first_data) {
+    std::cout << "Arena block is not recycled" << std::endl;
+    return 2;
+  }
+
+  const std::vector<std::vector<std::int64_t>> shapes = {{1, 5, 12}, {1, 288, 512, 3}, {256, 1024}};
+  for (auto& shape : shapes) {
+    std::size_t len = sizeof(float);
+    for (auto d : shape) {
+      len *= static_cast<std::size_t>(d);
+    }
+
+    auto heap = Measure(iterations, [&] {
+      return tf_utils::CreateEmptyTensor(TF_FLOAT, shape);
+    });
+    auto slabs = arena.slab_count();
+    auto pooled = Measure(iterations, [&] {
+      return arena.CreateTensor(TF_FLOAT, shape.data(), shape.size(), nullptr, len);
+    });
+    if (heap < 0.0 || pooled < 0.0) {
+      std::cout << "Can't create tensor" << std::endl;
+      return 3;
+    }
+    // One slab for a new size class at most, then every block is a recycled one.
+    if (arena.slab_count() > slabs + 1) {
+      std::cout << "Arena keeps mapping slabs" << std::endl;
+      return 4;
+    }
+
+    std::cout << len << " bytes: CreateEmptyTensor " << heap << " us, TensorArena " << pooled << " us" << std::endl;
+  }
+
+  std::cout << "Arena: " << arena.slab_count() << " slabs, " << arena.reserved_bytes() << " bytes"
+            << (options.huge_pages ? " on huge pages" : "") << std::endl;
+
+  return 0;
+}
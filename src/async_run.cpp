@@ -0,0 +1,104 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "async_session.hpp"
+#include <scope_guard.hpp>
+#include <condition_variable>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+// Usage: async_run [graph.pb] [runs]
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  const std::size_t runs = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<TF_Output> inputs = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Output> outputs = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  // Futures: the outputs belong to each RunResult and are deleted with it.
+  std::vector<std::future<tf_utils::RunResult>> futures;
+  for (std::size_t i = 0; i < runs; ++i) {
+    futures.push_back(tf_utils::RunSessionAsync(session, inputs, input_tensors, outputs));
+  }
+  for (auto& f : futures) {
+    auto result = f.get();
+    if (result.code != TF_OK) {
+      std::cout << "Error run session TF_CODE: " << result.code << " " << result.message << std::endl;
+      return result.code;
+    }
+  }
+
+  // Callbacks: the caller keeps working and only waits for the last one to finish.
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t done = 0;
+  std::size_t failed = 0;
+  float first = 0.0f;
+  for (std::size_t i = 0; i < runs; ++i) {
+    tf_utils::RunSessionAsync(session, inputs, input_tensors, outputs, [&](tf_utils::RunResult result) {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (result.code != TF_OK) {
+        ++failed;
+      } else if (done == 0) {
+        first = static_cast<float*>(TF_TensorData(result.output_tensors[0]))[0];
+      }
+      if (++done == runs) {
+        cv.notify_one();
+      }
+    });
+  }
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    cv.wait(lock, [&] { return done == runs; });
+  }
+  if (failed != 0) {
+    std::cout << failed << " runs failed" << std::endl;
+    return 1;
+  }
+
+  std::cout << 2 * runs << " async runs, output vals: " << first << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "async_session.hpp"
+#include <scope_guard.hpp>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace tf_utils {
+
+namespace {
+
+struct AsyncRun {
+  TF_Session* session;
+  std::vector<TF_Output> inputs;
+  std::vector<TF_Tensor*> input_tensors;
+  std::vector<TF_Output> outputs;
+  std::function<void(RunResult)> done;
+};
+
+} // namespace tf_utils::
+
+RunResult::RunResult(RunResult&& other) noexcept
+    : code{other.code},
+      message{std::move(other.message)},
+      output_tensors{std::move(other.output_tensors)} {
+  other.output_tensors.clear();
+}
+
+RunResult& RunResult::operator=(RunResult&& other) noexcept {
+  if (this != &other) {
+    DeleteTensors(output_tensors);
+    code = other.code;
+    message = std::move(other.message);
+    output_tensors = std::move(other.output_tensors);
+    other.output_tensors.clear();
+  }
+  return *this;
+}
+
+RunResult::~RunResult() {
+  DeleteTensors(output_tensors);
+}
+
+std::vector<TF_Tensor*> RunResult::Release() {
+  std::vector<TF_Tensor*> tensors;
+  tensors.swap(output_tensors);
+  return tensors;
+}
+
+TF_Code RunResult::ToStatus(TF_Status* status) const {
+  if (status != nullptr) {
+    TF_SetStatus(status, code, message.c_str());
+  }
+  return code;
+}
+
+ThreadPool& DefaultRunExecutor() {
+  static ThreadPool executor{std::thread::hardware_concurrency()};
+  return executor;
+}
+
+void RunSessionAsync(TF_Session* session,
+                     const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                     const std::vector<TF_Output>& outputs,
+                     std::function<void(RunResult)> done,
+                     ThreadPool* executor) {
+  if (executor == nullptr) {
+    executor = &DefaultRunExecutor();
+  }
+
+  auto run = std::make_shared<AsyncRun>();
+  run->session = session;
+  run->inputs = inputs;
+  run->input_tensors = input_tensors;
+  run->outputs = outputs;
+  run->done = std::move(done);
+
+  executor->Schedule([run] {
+    auto status = TF_NewStatus();
+    SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+    RunResult result;
+    result.output_tensors.resize(run->outputs.size(), nullptr);
+    result.code = RunSession(run->session, run->inputs, run->input_tensors, run->outputs, result.output_tensors, status);
+    if (result.code != TF_OK) {
+      result.message = TF_Message(status);
+    }
+    run->done(std::move(result));
+  });
+}
+
+std::future<RunResult> RunSessionAsync(TF_Session* session,
+                                       const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                                       const std::vector<TF_Output>& outputs,
+                                       ThreadPool* executor) {
+  auto promise = std::make_shared<std::promise<RunResult>>();
+  auto future = promise->get_future();
+  RunSessionAsync(session, inputs, input_tensors, outputs,
+                  [promise](RunResult result) { promise->set_value(std::move(result)); },
+                  executor);
+  return future;
+}
+
+} // namespace tf_utils
@@ -0,0 +1,75 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "thread_pool.hpp"
+#include "tf_utils.hpp"
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace tf_utils {
+
+// Outcome of an asynchronous run. Owns the output tensors until they are released.
+struct RunResult {
+  TF_Code code = TF_OK;
+  std::string message;
+  std::vector<TF_Tensor*> output_tensors;
+
+  RunResult() = default;
+
+  RunResult(RunResult&& other) noexcept;
+
+  RunResult& operator=(RunResult&& other) noexcept;
+
+  RunResult(const RunResult&) = delete;
+
+  RunResult& operator=(const RunResult&) = delete;
+
+  ~RunResult();
+
+  // Hands the output tensors to the caller, delete them with DeleteTensors.
+  std::vector<TF_Tensor*> Release();
+
+  // Copies the code and message into `status`.
+  TF_Code ToStatus(TF_Status* status) const;
+};
+
+// Process-wide executor of the async runs, one thread per core.
+ThreadPool& DefaultRunExecutor();
+
+// Runs the session on `executor` (DefaultRunExecutor if null) and calls `done` on that thread.
+// The session and input tensors must stay alive until `done` is called.
+void RunSessionAsync(TF_Session* session,
+                     const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                     const std::vector<TF_Output>& outputs,
+                     std::function<void(RunResult)> done,
+                     ThreadPool* executor = nullptr);
+
+std::future<RunResult> RunSessionAsync(TF_Session* session,
+                                       const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                                       const std::vector<TF_Output>& outputs,
+                                       ThreadPool* executor = nullptr);
+
+} // namespace tf_utils
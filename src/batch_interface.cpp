@@ -20,7 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include "tf_utils.hpp"
+#include "tensor.hpp"
 #include <scope_guard.hpp>
 #include <iostream>
 #include <vector>
@@ -59,10 +59,9 @@ int main() {
   const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals_batch)};
   SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
 
-  const std::vector<std::int64_t> output_dims = {2, 4}; // batch 2
   const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
-  std::vector<TF_Tensor*> output_tensors = {tf_utils::CreateEmptyTensor(TF_FLOAT, output_dims)};
-  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+  // TF_SessionRun allocates the outputs, a tensor created here would only be overwritten and leak.
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
 
   auto session = tf_utils::CreateSession(graph);
   SCOPE_EXIT{ tf_utils::DeleteSession(session); };
@@ -72,13 +71,13 @@ int main() {
   }
 
   auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  auto outputs = tf_utils::TakeTensors<float>(output_tensors);
 
   if (code == TF_OK) {
-    auto data = tf_utils::GetTensorsData<float>(output_tensors);
-    auto result = data[0];
-    std::cout << "batch: " << output_dims[0] << std::endl;
-    std::cout << "Output vals_1: " << result[0] << ", " << result[1] << ", " << result[2] << ", " << result[3] << std::endl;
-    std::cout << "Output vals_2: " << result[4] << ", " << result[5] << ", " << result[6] << ", " << result[7] << std::endl;
+    auto& result = outputs[0];
+    std::cout << "batch: " << result.dim(0) << std::endl;
+    std::cout << "Output vals_1: " << result(0, 0) << ", " << result(0, 1) << ", " << result(0, 2) << ", " << result(0, 3) << std::endl;
+    std::cout << "Output vals_2: " << result(1, 0) << ", " << result(1, 1) << ", " << result(1, 2) << ", " << result(1, 3) << std::endl;
   } else {
     std::cout << "Error run session TF_CODE: " << code;
     return code;
@@ -0,0 +1,99 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_signature.hpp"
+#include <scope_guard.hpp>
+#include <iostream>
+#include <vector>
+
+// Usage: bind_signature [graph.pb]
+
+static void PrintBinding(const char* kind, const tf_utils::TensorBinding& binding) {
+  std::cout << kind << " " << binding.name << ": " << tf_utils::DataTypeToString(binding.dtype) << " [";
+  if (binding.unknown_rank) {
+    std::cout << "?";
+  }
+  for (std::size_t i = 0; i < binding.shape.size(); ++i) {
+    std::cout << (i == 0 ? "" : ", ") << binding.shape[i];
+  }
+  std::cout << "]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto graph = tf_utils::LoadGraph(graph_path, status);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  // Typos fail here, at startup, instead of on the first request.
+  tf_utils::ModelSignature bad_signature;
+  if (bad_signature.Bind(graph, {"input_4:3"}, {"output_node0"}, status) != TF_NOT_FOUND ||
+      bad_signature.Bind(graph, {"input_4"}, {"output_node0:x"}, status) != TF_INVALID_ARGUMENT) {
+    std::cout << "Bad binding is not reported" << std::endl;
+    return 2;
+  }
+
+  tf_utils::ModelSignature signature;
+  if (signature.Bind(graph, {"input_4"}, {"output_node0:0"}, status) != TF_OK) {
+    std::cout << "Can't bind signature: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+  for (auto& b : signature.inputs()) {
+    PrintBinding("Input", b);
+  }
+  for (auto& b : signature.outputs()) {
+    PrintBinding("Output", b);
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  std::vector<TF_Tensor*> output_tensors;
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = signature.Run(session, input_tensors, output_tensors);
+  if (code != TF_OK) {
+    std::cout << "Error run session TF_CODE: " << code;
+    return code;
+  }
+
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <zlib.h>
+#if defined(TF_UTILS_WITH_ZSTD)
+#  include <zstd.h>
+#endif
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Usage: compressed_graph [graph.pb]
+
+static std::size_t CountOperations(TF_Graph* graph) {
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  while (TF_GraphNextOperation(graph, &pos) != nullptr) {
+    ++count;
+  }
+  return count;
+}
+
+static bool WriteGzip(const std::string& path, const std::string& data) {
+  auto f = gzopen(path.c_str(), "wb9");
+  if (f == nullptr) {
+    return false;
+  }
+  auto written = gzwrite(f, data.data(), static_cast<unsigned>(data.size()));
+  return gzclose(f) == Z_OK && written == static_cast<int>(data.size());
+}
+
+#if defined(TF_UTILS_WITH_ZSTD)
+static bool WriteZstd(const std::string& path, const std::string& data) {
+  std::string compressed(ZSTD_compressBound(data.size()), '\0');
+  auto size = ZSTD_compress(&compressed[0], compressed.size(), data.data(), data.size(), 19);
+  if (ZSTD_isError(size)) {
+    return false;
+  }
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  f.write(compressed.data(), static_cast<std::streamsize>(size));
+  return f.good();
+}
+#endif
+
+static int RunGraph(TF_Graph* graph) {
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  if (code != TF_OK) {
+    std::cout << "Error run session TF_CODE: " << code;
+    return code;
+  }
+
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  const std::string graph_path = argc > 1 ? argv[1] : "graph.pb";
+
+  std::ifstream f(graph_path, std::ios::binary);
+  const std::string graph_def{std::istreambuf_iterator<char>{f}, std::istreambuf_iterator<char>{}};
+  if (graph_def.empty()) {
+    std::cout << "Can't read " << graph_path << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> compressed_paths = {graph_path + ".gz"};
+  if (!WriteGzip(compressed_paths.back(), graph_def)) {
+    std::cout << "Can't write " << compressed_paths.back() << std::endl;
+    return 1;
+  }
+#if defined(TF_UTILS_WITH_ZSTD)
+  compressed_paths.push_back(graph_path + ".zst");
+  if (!WriteZstd(compressed_paths.back(), graph_def)) {
+    std::cout << "Can't write " << compressed_paths.back() << std::endl;
+    return 1;
+  }
+#endif
+
+  auto graph = tf_utils::LoadGraph(graph_path.c_str());
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph " << graph_path << std::endl;
+    return 1;
+  }
+  auto num_ops = CountOperations(graph);
+
+  for (auto& path : compressed_paths) {
+    auto buffer = tf_utils::ReadGraphDef(path.c_str());
+    SCOPE_EXIT{ TF_DeleteBuffer(buffer); };
+    if (buffer == nullptr || buffer->length != graph_def.size() ||
+        graph_def.compare(0, graph_def.size(), static_cast<const char*>(buffer->data), buffer->length) != 0) {
+      std::cout << "Decompressed " << path << " differs from " << graph_path << std::endl;
+      return 2;
+    }
+
+    auto compressed_graph = tf_utils::LoadGraph(path.c_str());
+    SCOPE_EXIT{ tf_utils::DeleteGraph(compressed_graph); };
+    if (compressed_graph == nullptr || CountOperations(compressed_graph) != num_ops) {
+      std::cout << "Can't load graph " << path << std::endl;
+      return 2;
+    }
+
+    std::cout << path << ": " << num_ops << " ops" << std::endl;
+    auto code = RunGraph(compressed_graph);
+    if (code != 0) {
+      return code;
+    }
+  }
+
+  return 0;
+}
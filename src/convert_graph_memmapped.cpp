@@ -0,0 +1,50 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <cstdlib>
+#include <iostream>
+
+// Usage: convert_graph_memmapped <graph.pb> <model_dir> [min_tensor_bytes]
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0] << " <graph.pb> <model_dir> [min_tensor_bytes]" << std::endl;
+    return 1;
+  }
+
+  auto min_tensor_bytes = argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : std::size_t{1024};
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto code = tf_utils::ConvertGraphToMemmapped(argv[1], argv[2], min_tensor_bytes, status);
+  if (code != TF_OK) {
+    std::cout << "Can't convert graph: " << TF_Message(status) << std::endl;
+    return 2;
+  }
+
+  std::cout << "Convert graph success" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "run_awaitable.hpp"
+#include <scope_guard.hpp>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+// Usage: coroutine_run [graph.pb] [requests]
+
+namespace {
+
+// Starts eagerly and frees its frame when the coroutine ends.
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+struct Counter {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::size_t pending = 0;
+  std::size_t failed = 0;
+  float first = 0.0f;
+};
+
+DetachedTask Infer(TF_Session* session,
+                   const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                   const std::vector<TF_Output>& outputs,
+                   tf_utils::ThreadPool& resume_on, Counter& counter) {
+  auto result = co_await tf_utils::RunSessionAwait(session, inputs, input_tensors, outputs, nullptr, &resume_on);
+
+  std::lock_guard<std::mutex> lock{counter.mutex};
+  if (result.code != TF_OK) {
+    ++counter.failed;
+  } else {
+    counter.first = static_cast<float*>(TF_TensorData(result.output_tensors[0]))[0];
+  }
+  if (--counter.pending == 0) {
+    counter.cv.notify_one();
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  const std::size_t requests = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<TF_Output> inputs = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Output> outputs = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  // Every coroutine continues on this one thread, the sessions run on the default executor.
+  Counter counter;
+  counter.pending = requests;
+  tf_utils::ThreadPool resume_on{1};
+  for (std::size_t i = 0; i < requests; ++i) {
+    Infer(session, inputs, input_tensors, outputs, resume_on, counter);
+  }
+  {
+    std::unique_lock<std::mutex> lock{counter.mutex};
+    counter.cv.wait(lock, [&] { return counter.pending == 0; });
+  }
+  if (counter.failed != 0) {
+    std::cout << counter.failed << " requests failed" << std::endl;
+    return 1;
+  }
+
+  std::cout << requests << " coroutines on " << tf_utils::DefaultRunExecutor().size() + resume_on.size()
+            << " threads, output vals: " << counter.first << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,179 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "inference_context.hpp"
+#include <scope_guard.hpp>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Usage: count_allocations [graph.pb] [iterations]
+
+#if defined(__GLIBC__)
+
+// Counts every heap allocation of the process, TensorFlow's included, by interposing glibc's allocator.
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+}
+
+static std::atomic<std::size_t> allocations{0};
+
+extern "C" void* malloc(std::size_t size) noexcept {
+  ++allocations;
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size) noexcept {
+  ++allocations;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, std::size_t size) noexcept {
+  ++allocations;
+  return __libc_realloc(ptr, size);
+}
+
+extern "C" void* memalign(std::size_t alignment, std::size_t size) noexcept {
+  ++allocations;
+  return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+  ++allocations;
+  return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) noexcept {
+  if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  ++allocations;
+  auto p = __libc_memalign(alignment, size);
+  if (p == nullptr) {
+    return ENOMEM;
+  }
+  *ptr = p;
+  return 0;
+}
+
+template <typename F>
+static double AllocationsPerRun(std::size_t iterations, F&& run) {
+  // Warm up so that lazily built state, like the context's input tensors, is not counted.
+  for (std::size_t i = 0; i < 3; ++i) {
+    if (!run()) {
+      return -1.0;
+    }
+  }
+
+  auto before = allocations.load();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    if (!run()) {
+      return -1.0;
+    }
+  }
+  return static_cast<double>(allocations.load() - before) / static_cast<double>(iterations);
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  const std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const TF_Output input = {TF_GraphOperationByName(graph, "input_4"), 0};
+  const TF_Output output = {TF_GraphOperationByName(graph, "output_node0"), 0};
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  // What TF_SessionRun itself allocates: everything else is prepared once.
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+  auto input_tensor = tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals);
+  SCOPE_EXIT{ tf_utils::DeleteTensor(input_tensor); };
+  auto baseline = AllocationsPerRun(iterations, [&] {
+    TF_Tensor* output_tensor = nullptr;
+    TF_SessionRun(session, nullptr, &input, &input_tensor, 1, &output, &output_tensor, 1, nullptr, 0, nullptr, status);
+    tf_utils::DeleteTensor(output_tensor);
+    return TF_GetCode(status) == TF_OK;
+  });
+
+  // The usual way: fresh vectors, tensors and status on every call.
+  auto per_call = AllocationsPerRun(iterations, [&] {
+    const std::vector<TF_Output> inputs = {input};
+    const std::vector<TF_Output> outputs = {output};
+    const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+    std::vector<TF_Tensor*> output_tensors = {nullptr};
+    auto code = tf_utils::RunSession(session, inputs, input_tensors, outputs, output_tensors);
+    tf_utils::DeleteTensors(input_tensors);
+    tf_utils::DeleteTensors(output_tensors);
+    return code == TF_OK;
+  });
+
+  tf_utils::InferenceContext context{session, {input}, {output}};
+  auto reused = AllocationsPerRun(iterations, [&] {
+    context.SetInput(0, TF_FLOAT, input_dims, input_vals);
+    return context.Run() == TF_OK;
+  });
+
+  if (baseline < 0.0 || per_call < 0.0 || reused < 0.0) {
+    std::cout << "Error run session" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Allocations per run, TF_SessionRun: " << baseline
+            << ", RunSession: " << per_call
+            << ", InferenceContext: " << reused << std::endl;
+
+  // Less than one extra allocation per run on average, whatever noise TensorFlow's own allocations have.
+  if (reused - baseline >= 1.0) {
+    std::cout << "InferenceContext allocates on the hot path" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
+
+#else
+
+int main() {
+  std::cout << "Counting allocations needs glibc" << std::endl;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,278 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <c_api.h> // TensorFlow C API header
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace tf_utils {
+
+namespace detail {
+
+static_assert(TF_FLOAT == 1 && TF_BFLOAT16 == 14 && TF_HALF == 19 && TF_UINT64 == 23, "Unexpected TF_DataType values");
+
+// Indexed by TF_DataType, 0 for the variable-size types like TF_DataTypeSize.
+constexpr std::size_t kDataTypeSizes[] = {
+    0,  // 0 is not a type
+    4,  // TF_FLOAT
+    8,  // TF_DOUBLE
+    4,  // TF_INT32
+    1,  // TF_UINT8
+    2,  // TF_INT16
+    1,  // TF_INT8
+    0,  // TF_STRING
+    8,  // TF_COMPLEX64
+    8,  // TF_INT64
+    1,  // TF_BOOL
+    1,  // TF_QINT8
+    1,  // TF_QUINT8
+    4,  // TF_QINT32
+    2,  // TF_BFLOAT16
+    2,  // TF_QINT16
+    2,  // TF_QUINT16
+    2,  // TF_UINT16
+    16, // TF_COMPLEX128
+    2,  // TF_HALF
+    0,  // TF_RESOURCE
+    0,  // TF_VARIANT
+    4,  // TF_UINT32
+    8,  // TF_UINT64
+};
+
+constexpr const char* kDataTypeNames[] = {
+    "Unknown",
+    "TF_FLOAT",
+    "TF_DOUBLE",
+    "TF_INT32",
+    "TF_UINT8",
+    "TF_INT16",
+    "TF_INT8",
+    "TF_STRING",
+    "TF_COMPLEX64",
+    "TF_INT64",
+    "TF_BOOL",
+    "TF_QINT8",
+    "TF_QUINT8",
+    "TF_QINT32",
+    "TF_BFLOAT16",
+    "TF_QINT16",
+    "TF_QUINT16",
+    "TF_UINT16",
+    "TF_COMPLEX128",
+    "TF_HALF",
+    "TF_RESOURCE",
+    "TF_VARIANT",
+    "TF_UINT32",
+    "TF_UINT64",
+};
+
+constexpr std::size_t kNumDataTypes = sizeof(kDataTypeSizes) / sizeof(kDataTypeSizes[0]);
+
+static_assert(kNumDataTypes == sizeof(kDataTypeNames) / sizeof(kDataTypeNames[0]), "Size and name tables differ");
+
+constexpr bool IsKnownDataType(TF_DataType data_type) {
+  return data_type > 0 && static_cast<std::size_t>(data_type) < kNumDataTypes;
+}
+
+} // namespace tf_utils::detail
+
+// Byte size of an element, 0 for TF_STRING, TF_RESOURCE, TF_VARIANT and unknown types.
+constexpr std::size_t DataTypeSize(TF_DataType data_type) {
+  return detail::IsKnownDataType(data_type) ? detail::kDataTypeSizes[data_type] : 0;
+}
+
+constexpr const char* DataTypeToString(TF_DataType data_type) {
+  return detail::IsKnownDataType(data_type) ? detail::kDataTypeNames[data_type] : "Unknown";
+}
+
+// IEEE 754 binary16, the bits TensorFlow stores for TF_HALF.
+struct Half {
+  std::uint16_t bits = 0;
+
+  Half() = default;
+
+  // Rounds to nearest even, out of range values become infinities.
+  explicit Half(float value) {
+    std::uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    const std::uint32_t sign = f & 0x80000000u;
+    f ^= sign;
+
+    if (f >= 0x47800000u) { // 65536, Inf and NaN.
+      bits = f > 0x7f800000u ? 0x7e00u : 0x7c00u;
+    } else if (f < 0x38800000u) { // Subnormal, adding 0.5 lets the FPU do the rounding.
+      float magic;
+      const std::uint32_t magic_bits = 0x3f000000u;
+      std::memcpy(&magic, &magic_bits, sizeof(magic));
+      float shifted;
+      std::memcpy(&shifted, &f, sizeof(shifted));
+      shifted += magic;
+      std::memcpy(&f, &shifted, sizeof(f));
+      bits = static_cast<std::uint16_t>(f - magic_bits);
+    } else {
+      const std::uint32_t odd = (f >> 13) & 1u;
+      f += 0xc8000fffu + odd; // Rebias the exponent from 127 to 15 and round.
+      bits = static_cast<std::uint16_t>(f >> 13);
+    }
+    bits = static_cast<std::uint16_t>(bits | (sign >> 16));
+  }
+
+  explicit operator float() const {
+    const std::uint32_t shifted_exp = 0x0f800000u; // 0x7c00 << 13
+    std::uint32_t f = (bits & 0x7fffu) << 13;
+    const std::uint32_t exp = f & shifted_exp;
+    f += 0x38000000u; // Rebias the exponent from 15 to 127.
+
+    if (exp == shifted_exp) { // Inf and NaN.
+      f += 0x38000000u;
+    } else if (exp == 0) { // Subnormal, renormalized by the FPU.
+      f += 0x00800000u;
+      float value;
+      std::memcpy(&value, &f, sizeof(value));
+      value -= 6.103515625e-05f; // 2^-14
+      std::memcpy(&f, &value, sizeof(f));
+    }
+    f |= static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+  }
+};
+
+// The upper half of a float, the bits TensorFlow stores for TF_BFLOAT16.
+struct BFloat16 {
+  std::uint16_t bits = 0;
+
+  BFloat16() = default;
+
+  // Rounds to nearest even, NaN stays a quiet NaN.
+  explicit BFloat16(float value) {
+    std::uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    if ((f & 0x7fffffffu) > 0x7f800000u) {
+      bits = static_cast<std::uint16_t>((f >> 16) | 0x0040u);
+    } else {
+      bits = static_cast<std::uint16_t>((f + 0x7fffu + ((f >> 16) & 1u)) >> 16);
+    }
+  }
+
+  explicit operator float() const {
+    const std::uint32_t f = static_cast<std::uint32_t>(bits) << 16;
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+  }
+};
+
+// TF_DataType of the C++ type T, left undefined for types TensorFlow has no dtype for.
+template <typename T>
+struct DataTypeOf;
+
+// C++ type of the elements of a fixed-size dtype, the quantized ones map to their storage.
+template <TF_DataType D>
+struct TypeOf;
+
+#define TF_UTILS_TYPE_OF(T, D)                                                          \
+  template <>                                                                           \
+  struct TypeOf<D> {                                                                    \
+    using type = T;                                                                     \
+    static_assert(sizeof(T) == DataTypeSize(D), "Element size differs from " #D);       \
+  };
+
+#define TF_UTILS_DATA_TYPE(T, D)                                                        \
+  TF_UTILS_TYPE_OF(T, D)                                                                \
+  template <>                                                                           \
+  struct DataTypeOf<T> : std::integral_constant<TF_DataType, D> {};
+
+TF_UTILS_DATA_TYPE(float, TF_FLOAT)
+TF_UTILS_DATA_TYPE(double, TF_DOUBLE)
+TF_UTILS_DATA_TYPE(std::int8_t, TF_INT8)
+TF_UTILS_DATA_TYPE(std::int16_t, TF_INT16)
+TF_UTILS_DATA_TYPE(std::int32_t, TF_INT32)
+TF_UTILS_DATA_TYPE(std::int64_t, TF_INT64)
+TF_UTILS_DATA_TYPE(std::uint8_t, TF_UINT8)
+TF_UTILS_DATA_TYPE(std::uint16_t, TF_UINT16)
+TF_UTILS_DATA_TYPE(std::uint32_t, TF_UINT32)
+TF_UTILS_DATA_TYPE(std::uint64_t, TF_UINT64)
+TF_UTILS_DATA_TYPE(bool, TF_BOOL)
+TF_UTILS_DATA_TYPE(std::complex<float>, TF_COMPLEX64)
+TF_UTILS_DATA_TYPE(std::complex<double>, TF_COMPLEX128)
+TF_UTILS_DATA_TYPE(Half, TF_HALF)
+TF_UTILS_DATA_TYPE(BFloat16, TF_BFLOAT16)
+TF_UTILS_TYPE_OF(std::int8_t, TF_QINT8)
+TF_UTILS_TYPE_OF(std::uint8_t, TF_QUINT8)
+TF_UTILS_TYPE_OF(std::int16_t, TF_QINT16)
+TF_UTILS_TYPE_OF(std::uint16_t, TF_QUINT16)
+TF_UTILS_TYPE_OF(std::int32_t, TF_QINT32)
+
+#undef TF_UTILS_DATA_TYPE
+#undef TF_UTILS_TYPE_OF
+
+namespace detail {
+
+template <typename T, typename = void>
+struct HasDataType : std::false_type {};
+
+template <typename T>
+struct HasDataType<T, decltype(void(DataTypeOf<T>::value))> : std::true_type {};
+
+// The quantized types are stored as the integers of TypeOf.
+constexpr TF_DataType StorageDataType(TF_DataType data_type) {
+  return data_type == TF_QINT8 ? TF_INT8 :
+         data_type == TF_QUINT8 ? TF_UINT8 :
+         data_type == TF_QINT16 ? TF_INT16 :
+         data_type == TF_QUINT16 ? TF_UINT16 :
+         data_type == TF_QINT32 ? TF_INT32 :
+         data_type;
+}
+
+// TF_HALF and TF_BFLOAT16 are also taken as their raw std::uint16_t bits.
+template <typename T>
+constexpr bool MatchesDataType(TF_DataType data_type, std::true_type) {
+  return DataTypeSize(data_type) == 0 ||
+         DataTypeOf<T>::value == StorageDataType(data_type) ||
+         (std::is_same<T, std::uint16_t>::value && (data_type == TF_HALF || data_type == TF_BFLOAT16));
+}
+
+template <typename T>
+constexpr bool MatchesDataType(TF_DataType data_type, std::false_type) {
+  return DataTypeSize(data_type) == 0 || DataTypeSize(data_type) == sizeof(T);
+}
+
+} // namespace tf_utils::detail
+
+// Whether a buffer of T holds elements of `data_type`, for the overloads that take the dtype at run time.
+// A T with a DataTypeOf has to be that dtype (or the storage of a quantized one, std::uint16_t also holds raw
+// TF_HALF and TF_BFLOAT16 bits), so std::int32_t doesn't pass for TF_FLOAT. Any other T only has to be the element
+// size. The variable-size types take their encoded bytes as is, whatever T is.
+template <typename T>
+constexpr bool MatchesDataType(TF_DataType data_type) {
+  return detail::MatchesDataType<T>(data_type, detail::HasDataType<T>{});
+}
+
+} // namespace tf_utils
@@ -55,9 +55,15 @@ int main() {
 	MagickReadImage(mw,"sample.jpg");
   MagickScaleImage(mw, 512, 288);
 
-  std::vector<std::uint8_t> pixels;
-  pixels.resize(512 * 288 * 3);
-  MagickExportImagePixels(mw, 0, 0, 512, 288, "RGB", CharPixel, pixels.data());
+  // Exported straight into the input tensor's buffer, aligned so that TF_NewTensor shares it.
+  const std::size_t pixels_size = 512 * 288 * 3;
+  void* pixels = nullptr;
+  if (posix_memalign(&pixels, tf_utils::kTensorAlignment, pixels_size) != 0) {
+    std::cout << "Can't allocate pixels" << std::endl;
+    return 1;
+  }
+  MAKE_SCOPE_EXIT(free_pixels){ std::free(pixels); };
+  MagickExportImagePixels(mw, 0, 0, 512, 288, "RGB", CharPixel, pixels);
   // std::cout << "pixels: " << pixels << std::endl;
 
 
@@ -111,7 +117,13 @@ int main() {
   }
 
   const std::vector<std::int64_t> input_dims = {1, 512, 288, 3};
-  TF_Tensor* input_tensor = tf_utils::CreateTensor(TF_UINT8, input_dims, pixels);
+  TF_Tensor* input_tensor = tf_utils::WrapTensor(TF_UINT8, input_dims.data(), input_dims.size(), pixels, pixels_size,
+                                                 [](void* data, std::size_t, void*) { std::free(data); }, nullptr);
+  if (input_tensor == nullptr) {
+    std::cout << "Can't wrap input tensor" << std::endl;
+    return 2;
+  }
+  free_pixels.dismiss();
   SCOPE_EXIT{ tf_utils::DeleteTensor(input_tensor); };
 
   const std::vector<std::int64_t> output_dims = {1, 512, 288};
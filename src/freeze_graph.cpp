@@ -0,0 +1,314 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Usage: freeze_graph [graph.pb] [checkpoint_prefix]
+//        freeze_graph --write-checkpoint graph.pb checkpoint_prefix
+// The second form builds a graph with a variable and a saver, saves a checkpoint of it and freezes it back.
+
+static std::size_t CountOperations(TF_Graph* graph, const char* op_type = nullptr) {
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  TF_Operation* oper = nullptr;
+  while ((oper = TF_GraphNextOperation(graph, &pos)) != nullptr) {
+    if (op_type == nullptr || std::strcmp(TF_OperationOpType(oper), op_type) == 0) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+static TF_Tensor* StringTensor(const std::vector<std::string>& strings, bool scalar, TF_Status* status) {
+  auto nbytes = 8 * strings.size(); // Start offsets.
+  for (auto& str : strings) {
+    nbytes += TF_StringEncodedSize(str.size());
+  }
+  const std::int64_t dims[] = {static_cast<std::int64_t>(strings.size())};
+  auto tensor = TF_AllocateTensor(TF_STRING, dims, scalar ? 0 : 1, nbytes);
+  auto data = static_cast<char*>(TF_TensorData(tensor));
+  auto offsets = reinterpret_cast<std::uint64_t*>(data);
+  std::size_t offset = 0;
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    offsets[i] = offset;
+    auto dst = data + 8 * strings.size() + offset;
+    offset += TF_StringEncode(strings[i].data(), strings[i].size(), dst, nbytes - 8 * strings.size() - offset, status);
+  }
+  return tensor;
+}
+
+static TF_Operation* AddConst(TF_Graph* graph, const char* name, TF_Tensor* value, TF_Status* status) {
+  SCOPE_EXIT{ tf_utils::DeleteTensor(value); };
+  auto desc = TF_NewOperation(graph, "Const", name);
+  TF_SetAttrType(desc, "dtype", TF_TensorType(value));
+  TF_SetAttrTensor(desc, "value", value, status);
+  return TF_FinishOperation(desc, status);
+}
+
+static TF_Operation* AddAssign(TF_Graph* graph, const char* name, TF_Output ref, TF_Output value, TF_Status* status) {
+  auto desc = TF_NewOperation(graph, "Assign", name);
+  TF_AddInput(desc, ref);
+  TF_AddInput(desc, value);
+  return TF_FinishOperation(desc, status);
+}
+
+// v = [1.5, -2] with v/Assign as its initializer, output = Identity(v), and the save/Const, save/SaveV2,
+// save/restore_all operations of a tf.train.Saver for it.
+static bool BuildCheckpointGraph(TF_Graph* graph, TF_Status* status) {
+  auto init = AddConst(graph, "init", tf_utils::CreateTensor({2}, std::vector<float>{1.5f, -2.0f}), status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  auto desc = TF_NewOperation(graph, "VariableV2", "v");
+  const std::int64_t shape[] = {2};
+  TF_SetAttrType(desc, "dtype", TF_FLOAT);
+  TF_SetAttrShape(desc, "shape", shape, 1);
+  auto variable = TF_FinishOperation(desc, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  AddAssign(graph, "v/Assign", {variable, 0}, {init, 0}, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  desc = TF_NewOperation(graph, "Identity", "output");
+  TF_AddInput(desc, {variable, 0});
+  TF_FinishOperation(desc, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  auto prefix = AddConst(graph, "save/Const", StringTensor({"model"}, true, status), status);
+  auto names = AddConst(graph, "save/SaveV2/tensor_names", StringTensor({"v"}, false, status), status);
+  auto slices = AddConst(graph, "save/SaveV2/shape_and_slices", StringTensor({""}, false, status), status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  desc = TF_NewOperation(graph, "SaveV2", "save/SaveV2");
+  TF_AddInput(desc, {prefix, 0});
+  TF_AddInput(desc, {names, 0});
+  TF_AddInput(desc, {slices, 0});
+  const TF_Output tensors[] = {{variable, 0}};
+  TF_AddInputList(desc, tensors, 1);
+  TF_FinishOperation(desc, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  desc = TF_NewOperation(graph, "RestoreV2", "save/RestoreV2");
+  TF_AddInput(desc, {prefix, 0});
+  TF_AddInput(desc, {names, 0});
+  TF_AddInput(desc, {slices, 0});
+  const TF_DataType dtypes[] = {TF_FLOAT};
+  TF_SetAttrTypeList(desc, "dtypes", dtypes, 1);
+  auto restore = TF_FinishOperation(desc, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  auto restore_assign = AddAssign(graph, "save/Assign", {variable, 0}, {restore, 0}, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  desc = TF_NewOperation(graph, "NoOp", "save/restore_all");
+  TF_AddControlInput(desc, restore_assign);
+  TF_FinishOperation(desc, status);
+  return TF_GetCode(status) == TF_OK;
+}
+
+static bool RunTarget(TF_Session* session, TF_Graph* graph, const char* target,
+                      const char* checkpoint_prefix, TF_Status* status) {
+  auto target_op = TF_GraphOperationByName(graph, target);
+  const TF_Output input = {TF_GraphOperationByName(graph, "save/Const"), 0};
+  auto prefix = checkpoint_prefix != nullptr ? StringTensor({checkpoint_prefix}, true, status) : nullptr;
+  SCOPE_EXIT{ tf_utils::DeleteTensor(prefix); };
+
+  TF_SessionRun(session, nullptr,
+                &input, &prefix, prefix != nullptr ? 1 : 0,
+                nullptr, nullptr, 0,
+                &target_op, 1,
+                nullptr, status);
+  return TF_GetCode(status) == TF_OK;
+}
+
+// Builds the graph, initializes the variable, saves it as `checkpoint_prefix` and writes the graph to `graph_path`.
+static bool WriteCheckpoint(const char* graph_path, const char* checkpoint_prefix, TF_Status* status) {
+  auto graph = TF_NewGraph();
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (!BuildCheckpointGraph(graph, status)) {
+    return false;
+  }
+
+  auto session = tf_utils::CreateSession(graph, status);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr ||
+      !RunTarget(session, graph, "v/Assign", nullptr, status) ||
+      !RunTarget(session, graph, "save/SaveV2", checkpoint_prefix, status)) {
+    return false;
+  }
+
+  auto buffer = TF_NewBuffer();
+  SCOPE_EXIT{ TF_DeleteBuffer(buffer); };
+  TF_GraphToGraphDef(graph, buffer, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+
+  std::ofstream file{graph_path, std::ios::binary};
+  file.write(static_cast<const char*>(buffer->data), static_cast<std::streamsize>(buffer->length));
+  return file.good();
+}
+
+// Freezes the graph of WriteCheckpoint, `output` has to give the saved value with no variable left.
+static int FreezeCheckpoint(const char* graph_path, const char* checkpoint_prefix, TF_Status* status) {
+  if (!WriteCheckpoint(graph_path, checkpoint_prefix, status)) {
+    std::cout << "Can't write checkpoint: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  tf_utils::LoadGraphOptions options;
+  options.freeze_variables = true;
+  auto graph = tf_utils::LoadGraph(graph_path, checkpoint_prefix, options, status);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't freeze graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+  if (CountOperations(graph, "VariableV2") != 0 || CountOperations(graph, "Assign") != 0) {
+    std::cout << "Variables left in the frozen graph" << std::endl;
+    return 3;
+  }
+
+  auto session = tf_utils::CreateSession(graph, status);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+  if (tf_utils::RunSession(session, {}, {}, out_ops, output_tensors, status) != TF_OK) {
+    std::cout << "Error run session: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  auto values = tf_utils::GetTensorData<float>(output_tensors[0]);
+  if (values != std::vector<float>{1.5f, -2.0f}) {
+    std::cout << "Frozen value differs from the checkpoint" << std::endl;
+    return 4;
+  }
+  std::cout << "Frozen value: " << values[0] << ", " << values[1] << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 3 && std::strcmp(argv[1], "--write-checkpoint") == 0) {
+    auto status = TF_NewStatus();
+    SCOPE_EXIT{ TF_DeleteStatus(status); };
+    return FreezeCheckpoint(argv[2], argv[3], status);
+  }
+
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  auto checkpoint_prefix = argc > 2 ? argv[2] : nullptr;
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  tf_utils::LoadGraphOptions options;
+  options.freeze_variables = true;
+
+  TF_Graph* graph = nullptr;
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (checkpoint_prefix == nullptr) {
+    // A frozen graph has nothing to restore.
+    auto frozen_graph = tf_utils::LoadGraph(graph_path, "model.ckpt", options, status);
+    if (frozen_graph != nullptr || TF_GetCode(status) != TF_NOT_FOUND) {
+      tf_utils::DeleteGraph(frozen_graph);
+      std::cout << "Freeze of a frozen graph is not reported" << std::endl;
+      return 2;
+    }
+    graph = tf_utils::LoadGraph(graph_path, status);
+  } else {
+    auto variable_graph = tf_utils::LoadGraph(graph_path, status);
+    SCOPE_EXIT{ tf_utils::DeleteGraph(variable_graph); };
+    if (variable_graph != nullptr) {
+      std::cout << "Checkpoint graph: " << CountOperations(variable_graph) << " ops, "
+                << CountOperations(variable_graph, "VariableV2") << " variables" << std::endl;
+    }
+    graph = tf_utils::LoadGraph(graph_path, checkpoint_prefix, options, status);
+  }
+
+  if (graph == nullptr) {
+    std::cout << "Can't load graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  auto num_variables = CountOperations(graph, "VariableV2") + CountOperations(graph, "Variable");
+  std::cout << "Frozen graph: " << CountOperations(graph) << " ops, " << num_variables << " variables" << std::endl;
+  if (num_variables != 0) {
+    std::cout << "Variables left in the frozen graph" << std::endl;
+    return 3;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  if (code != TF_OK) {
+    std::cout << "Error run session TF_CODE: " << code;
+    return code;
+  }
+
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  return 0;
+}
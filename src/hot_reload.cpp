@@ -0,0 +1,158 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "reloadable_model.hpp"
+#include <scope_guard.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Usage: hot_reload [graph.pb]
+
+static bool CopyFileAtomically(const char* from, const char* to) {
+  auto tmp = std::string{to} + ".tmp";
+  {
+    std::ifstream src(from, std::ios::binary);
+    std::ofstream dst(tmp, std::ios::binary | std::ios::trunc);
+    dst << src.rdbuf();
+    if (!src.good() || !dst.good()) {
+      return false;
+    }
+  }
+  return std::rename(tmp.c_str(), to) == 0;
+}
+
+static TF_Code RunModel(TF_Session* session, TF_Graph* graph) {
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  return tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  const char* model_path = "hot_reload.pb";
+  SCOPE_EXIT{ std::remove(model_path); };
+
+  if (!CopyFileAtomically(graph_path, model_path)) {
+    std::cout << "Can't copy " << graph_path << std::endl;
+    return 1;
+  }
+
+  tf_utils::ReloadOptions options;
+  options.poll_interval = std::chrono::milliseconds{20};
+  options.warmup = RunModel;
+
+  tf_utils::ReloadableModel model{model_path, options};
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+  if (model.Start(status) != TF_OK) {
+    std::cout << "Can't load model: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  std::weak_ptr<TF_Session> first_session = model.Get()->session;
+
+  std::atomic<bool> stop{false};
+  std::atomic<int> errors{0};
+  std::atomic<int> runs[2] = {};
+  std::vector<std::thread> clients;
+  for (int i = 0; i < 4; ++i) {
+    clients.emplace_back([&] {
+      while (!stop) {
+        auto version = model.Get();
+        if (RunModel(version->session.get(), version->graph.get()) != TF_OK) {
+          ++errors;
+        }
+        ++runs[version->version > 1 ? 1 : 0];
+      }
+    });
+  }
+
+  // Roll out a new version while the clients are running.
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+  if (!CopyFileAtomically(graph_path, model_path)) {
+    std::cout << "Can't copy " << graph_path << std::endl;
+    stop = true;
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (!stop && model.Get()->version < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+  stop = true;
+  for (auto& c : clients) {
+    c.join();
+  }
+  model.Stop();
+
+  std::cout << "Version: " << model.Get()->version << ", runs on the first version: " << runs[0]
+            << ", on the reloaded version: " << runs[1] << ", errors: " << errors << std::endl;
+
+  if (model.Get()->version != 2 || errors != 0) {
+    std::cout << "Model was not reloaded without errors" << std::endl;
+    return 2;
+  }
+  if (!first_session.expired()) {
+    std::cout << "First version is still alive after its runs drained" << std::endl;
+    return 2;
+  }
+
+  // A version that fails its warm-up is not loaded again until the file changes.
+  int warmups = 0;
+  tf_utils::ReloadOptions failing_options;
+  failing_options.warmup = [&warmups](TF_Session*, TF_Graph*) {
+    ++warmups;
+    return TF_INTERNAL;
+  };
+  tf_utils::ReloadableModel failing{model_path, failing_options};
+  for (int i = 0; i < 3; ++i) {
+    failing.Reload();
+  }
+  auto retried = warmups;
+  if (!CopyFileAtomically(graph_path, model_path)) {
+    std::cout << "Can't copy " << graph_path << std::endl;
+    return 1;
+  }
+  failing.Reload();
+
+  std::cout << "Warm-ups of a failing version: " << retried << ", after the file changed: " << warmups << std::endl;
+  if (retried != 1 || warmups != 2 || failing.Get() != nullptr) {
+    std::cout << "Unchanged failing file is retried" << std::endl;
+    return 3;
+  }
+
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "inference_context.hpp"
+#include <cstring>
+#include <utility>
+
+namespace tf_utils {
+
+namespace {
+
+bool SameShape(const TF_Tensor* tensor, TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, std::size_t len) {
+  if (TF_TensorType(tensor) != data_type ||
+      TF_NumDims(tensor) != static_cast<int>(num_dims) ||
+      TF_TensorByteSize(tensor) != len) {
+    return false;
+  }
+  for (std::size_t i = 0; i < num_dims; ++i) {
+    if (TF_Dim(tensor, static_cast<int>(i)) != dims[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<TF_Output> BindingOutputs(const std::vector<TensorBinding>& bindings) {
+  std::vector<TF_Output> outputs;
+  outputs.reserve(bindings.size());
+  for (auto& b : bindings) {
+    outputs.push_back(b.output);
+  }
+  return outputs;
+}
+
+} // namespace tf_utils::
+
+InferenceContext::InferenceContext(TF_Session* session, std::vector<TF_Output> inputs, std::vector<TF_Output> outputs)
+    : session_{session},
+      status_{TF_NewStatus()},
+      inputs_{std::move(inputs)},
+      outputs_{std::move(outputs)},
+      input_tensors_(inputs_.size(), nullptr),
+      output_tensors_(outputs_.size(), nullptr) {}
+
+InferenceContext::InferenceContext(TF_Session* session, const ModelSignature& signature)
+    : InferenceContext{session, BindingOutputs(signature.inputs()), BindingOutputs(signature.outputs())} {}
+
+InferenceContext::~InferenceContext() {
+  for (auto t : input_tensors_) {
+    DeleteTensor(t);
+  }
+  for (auto t : output_tensors_) {
+    DeleteTensor(t);
+  }
+  TF_DeleteStatus(status_);
+}
+
+TF_Tensor* InferenceContext::Input(std::size_t index, TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, std::size_t len) {
+  // An output may alias an input (Identity, Reshape, ...), drop them before the input is rewritten. Once they are
+  // gone nothing else refers to the buffer, TF_SessionRun releases its references to the inputs before returning.
+  DeleteOutputs();
+
+  auto& tensor = input_tensors_[index];
+  if (tensor != nullptr && SameShape(tensor, data_type, dims, num_dims, len)) {
+    return tensor;
+  }
+
+  DeleteTensor(tensor);
+  tensor = TF_AllocateTensor(data_type, dims, static_cast<int>(num_dims), len);
+  return tensor;
+}
+
+TF_Tensor* InferenceContext::SetInput(std::size_t index, TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims,
+                                      const void* data, std::size_t len) {
+  auto tensor = Input(index, data_type, dims, num_dims, len);
+  if (tensor != nullptr && data != nullptr) {
+    std::memcpy(TF_TensorData(tensor), data, len);
+  }
+  return tensor;
+}
+
+void InferenceContext::DeleteOutputs() {
+  for (auto& t : output_tensors_) {
+    DeleteTensor(t);
+    t = nullptr;
+  }
+}
+
+TF_Code InferenceContext::Run() {
+  DeleteOutputs();
+  for (auto t : input_tensors_) {
+    if (t == nullptr) {
+      TF_SetStatus(status_, TF_FAILED_PRECONDITION, "An input is not set");
+      return TF_FAILED_PRECONDITION;
+    }
+  }
+
+  return RunSession(session_,
+                    inputs_.data(), input_tensors_.data(), input_tensors_.size(),
+                    outputs_.data(), output_tensors_.data(), output_tensors_.size(),
+                    status_);
+}
+
+} // namespace tf_utils
@@ -0,0 +1,84 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "model_signature.hpp"
+#include "tf_utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tf_utils {
+
+// Reusable state to run one session over and over from one thread: its own status, the bound inputs
+// and outputs, and the input and output tensors. Once the input shapes stop changing, SetInput and Run
+// make no heap allocations besides the ones TensorFlow does for the output tensors.
+class InferenceContext {
+ public:
+  InferenceContext(TF_Session* session, std::vector<TF_Output> inputs, std::vector<TF_Output> outputs);
+
+  InferenceContext(TF_Session* session, const ModelSignature& signature);
+
+  ~InferenceContext();
+
+  InferenceContext(const InferenceContext&) = delete;
+
+  InferenceContext& operator=(const InferenceContext&) = delete;
+
+  // Tensor of input `index`, the previous one is kept if it has the same dtype and shape. Fill it through
+  // TF_TensorData, nullptr if it can't be allocated. Deletes the outputs of the last run, which may alias
+  // the input about to be rewritten, so copy anything needed from Output() before setting the next inputs.
+  TF_Tensor* Input(std::size_t index, TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, std::size_t len);
+
+  // Input with `len` bytes of `data` copied in.
+  TF_Tensor* SetInput(std::size_t index, TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims,
+                      const void* data, std::size_t len);
+
+  template <typename T>
+  TF_Tensor* SetInput(std::size_t index, TF_DataType data_type, const std::vector<std::int64_t>& dims, const std::vector<T>& data) {
+    if (!MatchesDataType<T>(data_type)) {
+      return nullptr;
+    }
+    return SetInput(index, data_type, dims.data(), dims.size(), data.data(), data.size() * sizeof(T));
+  }
+
+  // Deletes the outputs of the previous run and runs the session, status() has the details of an error.
+  TF_Code Run();
+
+  // Output `index` of the last run, owned by the context until the next Input, SetInput or Run.
+  TF_Tensor* Output(std::size_t index) const { return output_tensors_[index]; }
+
+  TF_Status* status() const { return status_; }
+
+ private:
+  void DeleteOutputs();
+
+  TF_Session* session_;
+  TF_Status* status_;
+  std::vector<TF_Output> inputs_;
+  std::vector<TF_Output> outputs_;
+  std::vector<TF_Tensor*> input_tensors_;
+  std::vector<TF_Tensor*> output_tensors_;
+};
+
+} // namespace tf_utils
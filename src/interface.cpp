@@ -20,7 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include "tf_utils.hpp"
+#include "tensor.hpp"
 #include <scope_guard.hpp>
 #include <iostream>
 #include <vector>
@@ -48,7 +48,6 @@ int main() {
 
   const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
   std::vector<TF_Tensor*> output_tensors = {nullptr};
-  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
 
   auto session = tf_utils::CreateSession(graph);
   SCOPE_EXIT{ tf_utils::DeleteSession(session); };
@@ -58,9 +57,10 @@ int main() {
   }
 
   auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  tf_utils::Tensor<float> output{output_tensors[0]};
 
   if (code == TF_OK) {
-    auto result = tf_utils::GetTensorData<float>(output_tensors[0]);
+    auto result = output.data();
     std::cout << "Output vals: " << result[0] << ", " << result[1] << ", " << result[2] << ", " << result[3] << std::endl;
   } else {
     std::cout << "Error run session TF_CODE: " << code;
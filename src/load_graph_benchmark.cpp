@@ -0,0 +1,123 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+// Usage: load_graph_benchmark [graph.pb] [iterations]
+
+static void DropFileCache(const char* file) {
+#if defined(__linux__)
+  // Evicts the clean pages of the file, so every iteration is a cold start.
+  auto fd = open(file, O_RDONLY);
+  if (fd >= 0) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#else
+  static_cast<void>(file);
+#endif
+}
+
+static std::size_t NumOperations(TF_Graph* graph) {
+  std::size_t pos = 0;
+  std::size_t num = 0;
+  while (TF_GraphNextOperation(graph, &pos) != nullptr) {
+    ++num;
+  }
+  return num;
+}
+
+static bool Measure(const char* name, const char* graph_path, int iterations, bool cold,
+                    const tf_utils::LoadGraphOptions& options, std::size_t* num_ops) {
+  std::vector<double> times;
+  times.reserve(iterations);
+
+  for (int i = 0; i < iterations; ++i) {
+    if (cold) {
+      DropFileCache(graph_path);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto graph = tf_utils::LoadGraph(graph_path, nullptr, options);
+    auto stop = std::chrono::steady_clock::now();
+    SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+
+    if (graph == nullptr) {
+      std::cout << "Can't load graph" << std::endl;
+      return false;
+    }
+    *num_ops = NumOperations(graph);
+    times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+
+  std::sort(times.begin(), times.end());
+  auto mean = 0.0;
+  for (auto t : times) {
+    mean += t;
+  }
+  mean /= times.size();
+
+  std::cout << name << (cold ? " cold" : " warm")
+            << " mean: " << mean << " ms"
+            << " min: " << times.front() << " ms"
+            << " median: " << times[times.size() / 2] << " ms"
+            << " max: " << times.back() << " ms" << std::endl;
+
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  auto iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+  tf_utils::LoadGraphOptions read_options;
+  tf_utils::LoadGraphOptions mmap_options;
+  mmap_options.memory_map = true;
+
+  std::size_t read_ops = 0;
+  std::size_t mmap_ops = 0;
+
+  for (auto cold : {true, false}) {
+    if (!Measure("read", graph_path, iterations, cold, read_options, &read_ops) ||
+        !Measure("mmap", graph_path, iterations, cold, mmap_options, &mmap_ops)) {
+      return 1;
+    }
+  }
+
+  if (read_ops != mmap_ops) {
+    std::cout << "Graphs differ: " << read_ops << " vs " << mmap_ops << " operations" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
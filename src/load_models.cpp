@@ -0,0 +1,73 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_loader.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Usage: load_models [num_models] [num_threads]
+
+int main(int argc, char* argv[]) {
+  auto num_models = argc > 1 ? std::max(1, std::atoi(argv[1])) : 8;
+  auto num_threads = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4;
+
+  std::vector<tf_utils::ModelSpec> specs(num_models);
+  for (auto i = 0; i < num_models; ++i) {
+    specs[i].graph_path = "graph.pb";
+    specs[i].options.memory_map = i % 2 == 1;
+  }
+  // Errors are reported per model and do not stop the others.
+  specs.emplace_back();
+  specs.back().graph_path = "missing.pb";
+  // Pruning applies as in LoadGraph, a fetch the graph doesn't have fails the model.
+  specs.emplace_back();
+  specs.back().graph_path = "graph.pb";
+  specs.back().options.fetches = {"missing_output:0"};
+
+  auto models = tf_utils::LoadModels(specs, static_cast<std::size_t>(num_threads), &std::cout);
+  SCOPE_EXIT{ tf_utils::DeleteModels(models); };
+
+  for (auto i = 0; i < num_models; ++i) {
+    if (models[i].session == nullptr || TF_GetCode(models[i].status) != TF_OK) {
+      std::cout << "Can't load model " << i << ": " << TF_Message(models[i].status) << std::endl;
+      return 1;
+    }
+  }
+
+  auto& missing_model = models[num_models];
+  if (missing_model.session != nullptr || TF_GetCode(missing_model.status) != TF_NOT_FOUND) {
+    std::cout << "Missing model is not reported" << std::endl;
+    return 2;
+  }
+
+  if (models.back().session != nullptr || TF_GetCode(models.back().status) != TF_NOT_FOUND) {
+    std::cout << "Missing fetch is not reported" << std::endl;
+    return 2;
+  }
+
+  std::cout << "Load models success" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <iostream>
+#include <vector>
+
+// Usage: load_session [graph.pb] [checkpoint_prefix]
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  auto checkpoint_prefix = argc > 2 ? argv[2] : nullptr;
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  TF_Graph* graph = nullptr;
+  auto session = tf_utils::LoadSession(graph_path, checkpoint_prefix, &graph, status);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't load session: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  // A frozen graph has nothing to restore.
+  if (checkpoint_prefix == nullptr) {
+    TF_Graph* frozen_graph = nullptr;
+    auto frozen_session = tf_utils::LoadSession(graph_path, "model.ckpt", &frozen_graph, status);
+    if (frozen_session != nullptr || frozen_graph != nullptr || TF_GetCode(status) != TF_NOT_FOUND) {
+      tf_utils::DeleteSession(frozen_session);
+      tf_utils::DeleteGraph(frozen_graph);
+      std::cout << "Restore of a frozen graph is not reported" << std::endl;
+      return 2;
+    }
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  if (code != TF_OK) {
+    std::cout << "Error run session TF_CODE: " << code;
+    return code;
+  }
+
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_loader.hpp"
+#include "thread_pool.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace tf_utils {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static bool CreateModelSession(const ModelSpec& spec, LoadedModel* model) {
+  auto start = Clock::now();
+  model->session = spec.session_options == nullptr ? CreateSession(model->graph, model->status)
+                                                   : CreateSession(model->graph, spec.session_options, model->status);
+  model->session_ms = ElapsedMs(start);
+  if (model->session == nullptr) {
+    DeleteGraph(model->graph);
+    model->graph = nullptr;
+    return false;
+  }
+  return true;
+}
+
+static void LoadModel(const ModelSpec& spec, LoadedModel* model) {
+  if (spec.options.freeze_variables && !spec.checkpoint_prefix.empty()) {
+    // LoadGraph restores the checkpoint on a session of its own to freeze it, the model's session runs
+    // the frozen graph and has nothing left to restore. The whole load counts as restore time.
+    auto start = Clock::now();
+    model->graph = LoadGraph(spec.graph_path.c_str(), spec.checkpoint_prefix.c_str(), spec.options, model->status);
+    model->restore_ms = ElapsedMs(start);
+    if (model->graph != nullptr) {
+      CreateModelSession(spec, model);
+    }
+    return;
+  }
+
+  auto start = Clock::now();
+  auto buffer = ReadGraphDef(spec.graph_path.c_str(), spec.options);
+  model->read_ms = ElapsedMs(start);
+  if (buffer == nullptr) {
+    TF_SetStatus(model->status, TF_NOT_FOUND, ("Can't read GraphDef file " + spec.graph_path).c_str());
+    return;
+  }
+
+  start = Clock::now();
+  if (!spec.options.fetches.empty()) {
+    auto fetches = spec.options.fetches;
+    if (!spec.checkpoint_prefix.empty()) {
+      // The variables are only initialized by the restore ops, as in LoadGraph.
+      fetches.push_back("save/restore_all");
+    }
+    auto pruned = PruneGraphDef(buffer, spec.options.feeds, fetches, spec.options.prune_stats, model->status);
+    TF_DeleteBuffer(buffer);
+    buffer = pruned;
+  }
+  model->graph = buffer != nullptr ? ImportGraphDef(buffer, model->status) : nullptr;
+  TF_DeleteBuffer(buffer);
+  model->import_ms = ElapsedMs(start);
+  if (model->graph == nullptr || !CreateModelSession(spec, model)) {
+    return;
+  }
+
+  if (spec.checkpoint_prefix.empty()) {
+    return;
+  }
+
+  start = Clock::now();
+  auto code = RestoreCheckpoint(model->session, model->graph, spec.checkpoint_prefix.c_str(), model->status);
+  model->restore_ms = ElapsedMs(start);
+  if (code != TF_OK) {
+    DeleteSession(model->session);
+    DeleteGraph(model->graph);
+    model->session = nullptr;
+    model->graph = nullptr;
+  }
+}
+
+} // namespace tf_utils::
+
+std::vector<LoadedModel> LoadModels(const std::vector<ModelSpec>& specs, std::size_t num_threads, std::ostream* timings) {
+  auto start = Clock::now();
+  std::vector<LoadedModel> models(specs.size());
+  for (auto& m : models) {
+    m.status = TF_NewStatus();
+  }
+
+  {
+    ThreadPool pool{std::min(num_threads, specs.size())};
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+      pool.Schedule([&specs, &models, i] { LoadModel(specs[i], &models[i]); });
+    }
+  } // Waits for all models.
+
+  if (timings != nullptr) {
+    auto wall_ms = ElapsedMs(start);
+    auto read_ms = 0.0;
+    auto import_ms = 0.0;
+    auto session_ms = 0.0;
+    auto restore_ms = 0.0;
+    auto& os = *timings;
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < specs.size(); ++i) {
+      auto& m = models[i];
+      os << specs[i].graph_path
+         << " read: " << m.read_ms << " ms"
+         << " import: " << m.import_ms << " ms"
+         << " session: " << m.session_ms << " ms"
+         << " restore: " << m.restore_ms << " ms"
+         << " status: " << CodeToString(TF_GetCode(m.status)) << std::endl;
+      read_ms += m.read_ms;
+      import_ms += m.import_ms;
+      session_ms += m.session_ms;
+      restore_ms += m.restore_ms;
+    }
+    os << "Total read: " << read_ms << " ms"
+       << " import: " << import_ms << " ms"
+       << " session: " << session_ms << " ms"
+       << " restore: " << restore_ms << " ms"
+       << " wall: " << wall_ms << " ms"
+       << " threads: " << std::min(num_threads, specs.size()) << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+  }
+
+  return models;
+}
+
+void DeleteModels(const std::vector<LoadedModel>& models) {
+  for (auto& m : models) {
+    DeleteSession(m.session);
+    DeleteGraph(m.graph);
+    TF_DeleteStatus(m.status);
+  }
+}
+
+} // namespace tf_utils
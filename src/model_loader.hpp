@@ -0,0 +1,61 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace tf_utils {
+
+struct ModelSpec {
+  std::string graph_path;
+  // Empty if the graph has no variables to restore.
+  std::string checkpoint_prefix;
+  // Memory mapping, pruning and freezing as in LoadGraph.
+  LoadGraphOptions options;
+  // Not owned, nullptr for the default session options.
+  const TF_SessionOptions* session_options = nullptr;
+};
+
+struct LoadedModel {
+  TF_Graph* graph = nullptr;
+  TF_Session* session = nullptr;
+  // Result of this model, the other models load regardless of it.
+  TF_Status* status = nullptr;
+  // Time spent in each phase, in milliseconds.
+  double read_ms = 0.0;
+  double import_ms = 0.0;
+  double session_ms = 0.0;
+  double restore_ms = 0.0;
+};
+
+// Reads, imports, creates a session and restores the checkpoint for every model on `num_threads` threads.
+// If `timings` is set, writes the time of every phase per model there.
+std::vector<LoadedModel> LoadModels(const std::vector<ModelSpec>& specs, std::size_t num_threads, std::ostream* timings = nullptr);
+
+void DeleteModels(const std::vector<LoadedModel>& models);
+
+} // namespace tf_utils
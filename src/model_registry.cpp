@@ -0,0 +1,171 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_registry.hpp"
+#include <scope_guard.hpp>
+
+#if defined(_WIN32)
+#  include <sys/stat.h>
+#  include <stdlib.h>
+#else
+#  include <climits>
+#  include <cstdlib>
+#  include <sys/stat.h>
+#endif
+
+namespace tf_utils {
+
+bool StatFile(const char* file, std::string* path, std::int64_t* mtime, std::int64_t* size) {
+#if defined(_WIN32)
+  char buf[_MAX_PATH];
+  if (_fullpath(buf, file, _MAX_PATH) == nullptr) {
+    return false;
+  }
+  struct _stat64 st;
+  if (_stat64(buf, &st) != 0) {
+    return false;
+  }
+  *mtime = static_cast<std::int64_t>(st.st_mtime);
+#else
+  char buf[PATH_MAX];
+  if (realpath(file, buf) == nullptr) {
+    return false;
+  }
+  struct stat st;
+  if (stat(buf, &st) != 0) {
+    return false;
+  }
+#  if defined(__APPLE__)
+  *mtime = static_cast<std::int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#  else
+  *mtime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#  endif
+#endif
+  *path = buf;
+  *size = static_cast<std::int64_t>(st.st_size);
+  return true;
+}
+
+SessionHandle CreateSession(const GraphHandle& graph, const TF_SessionOptions* options, TF_Status* status) {
+  if (graph == nullptr) {
+    return nullptr;
+  }
+
+  auto session = options == nullptr ? CreateSession(graph.get(), status) : CreateSession(graph.get(), options, status);
+  if (session == nullptr) {
+    return nullptr;
+  }
+
+  // The deleter owns a graph reference, so the graph is released only after the session.
+  return SessionHandle{session, [graph](TF_Session* s) { DeleteSession(s); }};
+}
+
+ModelRegistry& ModelRegistry::Instance() {
+  static ModelRegistry registry;
+  return registry;
+}
+
+GraphHandle ModelRegistry::GetGraph(const char* graph_path, const LoadGraphOptions& options, TF_Status* status) {
+  if (graph_path == nullptr) {
+    return nullptr;
+  }
+
+  Key key;
+  if (!StatFile(graph_path, &key.path, &key.mtime, &key.size)) {
+    if (status != nullptr) {
+      TF_SetStatus(status, TF_NOT_FOUND, "Can't find GraphDef file");
+    }
+    return nullptr;
+  }
+  key.feeds = options.feeds;
+  key.fetches = options.fetches;
+
+  std::shared_ptr<std::mutex> load_mutex;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto& entry = graphs_[key];
+    if (auto graph = entry.graph.lock()) {
+      if (options.prune_stats != nullptr) {
+        *options.prune_stats = entry.prune_stats;
+      }
+      return graph;
+    }
+    load_mutex = entry.load_mutex;
+  }
+
+  // Loads of the same model are serialized, loads of different models run in parallel.
+  std::lock_guard<std::mutex> load_lock{*load_mutex};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto& entry = graphs_[key];
+    if (auto graph = entry.graph.lock()) {
+      if (options.prune_stats != nullptr) {
+        *options.prune_stats = entry.prune_stats;
+      }
+      return graph;
+    }
+  }
+
+  // The stats are kept for later hits, whether or not this caller asked for them.
+  PruneStats prune_stats;
+  auto load_options = options;
+  load_options.prune_stats = &prune_stats;
+  auto graph = GraphHandle{LoadGraph(key.path.c_str(), nullptr, load_options, status), DeleteGraph};
+  if (graph == nullptr) {
+    return nullptr;
+  }
+  if (options.prune_stats != nullptr) {
+    *options.prune_stats = prune_stats;
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  // Drop entries of graphs nobody uses anymore, e.g. older versions of a changed file.
+  for (auto it = graphs_.begin(); it != graphs_.end();) {
+    if (it->second.graph.expired() && it->second.load_mutex.use_count() == 1) {
+      it = graphs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  auto& entry = graphs_[key];
+  entry.graph = graph;
+  entry.prune_stats = prune_stats;
+
+  return graph;
+}
+
+GraphHandle ModelRegistry::GetGraph(const char* graph_path, TF_Status* status) {
+  return GetGraph(graph_path, LoadGraphOptions{}, status);
+}
+
+std::size_t ModelRegistry::size() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  std::size_t size = 0;
+  for (auto& g : graphs_) {
+    if (!g.second.graph.expired()) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+} // namespace tf_utils
@@ -0,0 +1,88 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tf_utils {
+
+// Shared ownership of an imported graph, DeleteGraph is called when the last handle goes away.
+using GraphHandle = std::shared_ptr<TF_Graph>;
+
+// Session that keeps its graph alive until the session itself is deleted.
+using SessionHandle = std::shared_ptr<TF_Session>;
+
+SessionHandle CreateSession(const GraphHandle& graph, const TF_SessionOptions* options = nullptr, TF_Status* status = nullptr);
+
+// Canonical path, modification time and size of `file`, what ModelRegistry tells versions of a file apart by.
+bool StatFile(const char* file, std::string* path, std::int64_t* mtime, std::int64_t* size);
+
+// Process-wide cache of imported graphs, keyed by canonical path, modification time and size,
+// so that every session over the same model file shares one TF_Graph.
+class ModelRegistry {
+ public:
+  static ModelRegistry& Instance();
+
+  // Returns the already imported graph or imports it. A file that changed on disk is imported again,
+  // graphs handed out before keep working until released. options.prune_stats is filled in from the
+  // first import on a cache hit too.
+  GraphHandle GetGraph(const char* graph_path, const LoadGraphOptions& options, TF_Status* status = nullptr);
+
+  GraphHandle GetGraph(const char* graph_path, TF_Status* status = nullptr);
+
+  // Number of graphs that are still referenced.
+  std::size_t size() const;
+
+ private:
+  struct Key {
+    std::string path;
+    std::int64_t mtime;
+    std::int64_t size;
+    // A pruned graph is a different graph.
+    std::vector<std::string> feeds;
+    std::vector<std::string> fetches;
+
+    bool operator<(const Key& other) const {
+      return std::tie(path, mtime, size, feeds, fetches) <
+             std::tie(other.path, other.mtime, other.size, other.feeds, other.fetches);
+    }
+  };
+
+  struct Entry {
+    std::weak_ptr<TF_Graph> graph;
+    PruneStats prune_stats;
+    std::shared_ptr<std::mutex> load_mutex = std::make_shared<std::mutex>();
+  };
+
+  mutable std::mutex mutex_;
+  std::map<Key, Entry> graphs_;
+};
+
+} // namespace tf_utils
@@ -0,0 +1,155 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_signature.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace tf_utils {
+
+namespace {
+
+static bool BindTensor(TF_Graph* graph, const std::string& name, TensorBinding* binding, TF_Status* status) {
+  binding->name = name;
+  binding->output = ResolveOutput(graph, name, status);
+  if (binding->output.oper == nullptr) {
+    return false;
+  }
+  binding->dtype = TF_OperationOutputType(binding->output);
+
+  auto num_dims = TF_GraphGetTensorNumDims(graph, binding->output, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return false;
+  }
+  binding->unknown_rank = num_dims < 0;
+  binding->shape.assign(num_dims < 0 ? 0 : static_cast<std::size_t>(num_dims), -1);
+  if (num_dims > 0) {
+    TF_GraphGetTensorShape(graph, binding->output, binding->shape.data(), num_dims, status);
+  }
+
+  return TF_GetCode(status) == TF_OK;
+}
+
+static int FindBinding(const std::vector<TensorBinding>& bindings, const std::string& name) {
+  auto it = std::find_if(bindings.begin(), bindings.end(), [&name](const TensorBinding& b) { return b.name == name; });
+  return it == bindings.end() ? -1 : static_cast<int>(it - bindings.begin());
+}
+
+} // namespace tf_utils::
+
+TF_Output ResolveOutput(TF_Graph* graph, const std::string& name, TF_Status* status) {
+  if (graph == nullptr) {
+    return {nullptr, 0};
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto op_name = name;
+  auto index = 0L;
+  auto colon = name.rfind(':');
+  if (colon != std::string::npos) {
+    char* end = nullptr;
+    index = std::strtol(name.c_str() + colon + 1, &end, 10);
+    if (colon + 1 == name.size() || *end != '\0' || index < 0) {
+      TF_SetStatus(status, TF_INVALID_ARGUMENT, ("Malformed tensor name " + name).c_str());
+      return {nullptr, 0};
+    }
+    op_name = name.substr(0, colon);
+  }
+
+  auto oper = TF_GraphOperationByName(graph, op_name.c_str());
+  if (oper == nullptr || index >= TF_OperationNumOutputs(oper)) {
+    TF_SetStatus(status, TF_NOT_FOUND, ("Tensor " + name + " is not in the graph").c_str());
+    return {nullptr, 0};
+  }
+
+  TF_SetStatus(status, TF_OK, "");
+  return {oper, static_cast<int>(index)};
+}
+
+TF_Code ModelSignature::Bind(TF_Graph* graph, const std::vector<std::string>& inputs, const std::vector<std::string>& outputs,
+                             TF_Status* status) {
+  if (graph == nullptr) {
+    return TF_INVALID_ARGUMENT;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  std::vector<TensorBinding> input_bindings(inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (!BindTensor(graph, inputs[i], &input_bindings[i], status)) {
+      return TF_GetCode(status);
+    }
+  }
+  std::vector<TensorBinding> output_bindings(outputs.size());
+  for (std::size_t i = 0; i < outputs.size(); ++i) {
+    if (!BindTensor(graph, outputs[i], &output_bindings[i], status)) {
+      return TF_GetCode(status);
+    }
+  }
+
+  inputs_ = std::move(input_bindings);
+  outputs_ = std::move(output_bindings);
+  input_ops_.clear();
+  for (auto& b : inputs_) {
+    input_ops_.push_back(b.output);
+  }
+  output_ops_.clear();
+  for (auto& b : outputs_) {
+    output_ops_.push_back(b.output);
+  }
+
+  return TF_OK;
+}
+
+int ModelSignature::InputIndex(const std::string& name) const {
+  return FindBinding(inputs_, name);
+}
+
+int ModelSignature::OutputIndex(const std::string& name) const {
+  return FindBinding(outputs_, name);
+}
+
+TF_Code ModelSignature::Run(TF_Session* session, const std::vector<TF_Tensor*>& input_tensors, std::vector<TF_Tensor*>& output_tensors,
+                            TF_Status* status) const {
+  if (input_tensors.size() != input_ops_.size()) {
+    if (status != nullptr) {
+      TF_SetStatus(status, TF_INVALID_ARGUMENT, "Number of input tensors does not match the signature");
+    }
+    return TF_INVALID_ARGUMENT;
+  }
+
+  output_tensors.resize(output_ops_.size(), nullptr);
+  return RunSession(session, input_ops_, input_tensors, output_ops_, output_tensors, status);
+}
+
+} // namespace tf_utils
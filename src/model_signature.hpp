@@ -0,0 +1,74 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tf_utils {
+
+struct TensorBinding {
+  std::string name;
+  TF_Output output = {nullptr, 0};
+  TF_DataType dtype = static_cast<TF_DataType>(0);
+  // Static shape from the graph, -1 for unknown dimensions. Empty with `unknown_rank` if nothing is known.
+  std::vector<std::int64_t> shape;
+  bool unknown_rank = false;
+};
+
+// Looks up an "op_name" or "op_name:index" tensor, {nullptr, 0} with the status set if there is none.
+TF_Output ResolveOutput(TF_Graph* graph, const std::string& name, TF_Status* status = nullptr);
+
+// Inputs and outputs of a model resolved once at load time. The run path indexes the bindings
+// by position and never touches a name.
+class ModelSignature {
+ public:
+  // Resolves all names, the first missing or malformed one fails the whole signature.
+  TF_Code Bind(TF_Graph* graph, const std::vector<std::string>& inputs, const std::vector<std::string>& outputs,
+               TF_Status* status = nullptr);
+
+  const std::vector<TensorBinding>& inputs() const { return inputs_; }
+
+  const std::vector<TensorBinding>& outputs() const { return outputs_; }
+
+  // Position of a binding by name, -1 if there is none. Meant for setup code, not the run path.
+  int InputIndex(const std::string& name) const;
+
+  int OutputIndex(const std::string& name) const;
+
+  // Runs with `input_tensors` in binding order, the outputs are returned in binding order too.
+  TF_Code Run(TF_Session* session, const std::vector<TF_Tensor*>& input_tensors, std::vector<TF_Tensor*>& output_tensors,
+              TF_Status* status = nullptr) const;
+
+ private:
+  std::vector<TensorBinding> inputs_;
+  std::vector<TensorBinding> outputs_;
+  // Contiguous copies of the bindings' outputs, as TF_SessionRun wants them.
+  std::vector<TF_Output> input_ops_;
+  std::vector<TF_Output> output_ops_;
+};
+
+} // namespace tf_utils
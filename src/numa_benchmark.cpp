@@ -0,0 +1,125 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "placement.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Usage: numa_benchmark [graph.pb] [runs_per_node] [clients_per_node]
+
+// Runs on one placed session per node, with clients and inputs on the same node. Returns runs per second.
+static double Benchmark(TF_Graph* graph, int num_nodes, int runs_per_node, int clients_per_node) {
+  std::vector<TF_Session*> sessions;
+  SCOPE_EXIT{ for (auto s : sessions) tf_utils::DeleteSession(s); };
+  for (int node = 0; node < num_nodes; ++node) {
+    tf_utils::Placement placement;
+    placement.numa_node = node;
+    auto session = tf_utils::CreatePlacedSession(graph, placement);
+    if (session == nullptr) {
+      return -1.0;
+    }
+    sessions.push_back(session);
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+
+  std::atomic<int> errors{0};
+  std::vector<std::thread> clients;
+  auto start = std::chrono::steady_clock::now();
+  for (int node = 0; node < num_nodes; ++node) {
+    for (int c = 0; c < clients_per_node; ++c) {
+      clients.emplace_back([&, node] {
+        tf_utils::Placement placement;
+        placement.numa_node = node;
+        if (tf_utils::BindCurrentThread(placement) != TF_OK) {
+          ++errors;
+          return;
+        }
+
+        const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensorOnNode(TF_FLOAT, input_dims, input_vals, node)};
+        SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+        for (int r = 0; r < runs_per_node / clients_per_node; ++r) {
+          std::vector<TF_Tensor*> output_tensors = {nullptr};
+          SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+          if (tf_utils::RunSession(sessions[node], input_ops, input_tensors, out_ops, output_tensors) != TF_OK) {
+            ++errors;
+            return;
+          }
+        }
+      });
+    }
+  }
+  for (auto& c : clients) {
+    c.join();
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  if (errors != 0) {
+    return -1.0;
+  }
+  auto runs = num_nodes * (runs_per_node / clients_per_node) * clients_per_node;
+  return runs / std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  // Gives every session its own intra-op pool, which then inherits the session's placement.
+  // Must be set before the first session is created.
+  setenv("TF_OVERRIDE_GLOBAL_THREADPOOL", "1", 0);
+
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  auto runs_per_node = argc > 2 ? std::atoi(argv[2]) : 200;
+  auto clients_per_node = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2;
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto num_nodes = tf_utils::NumaNodeCount();
+  double single_node = 0.0;
+  for (int n = 1; n <= num_nodes; ++n) {
+    auto runs_per_second = Benchmark(graph, n, runs_per_node, clients_per_node);
+    if (runs_per_second < 0.0) {
+      std::cout << "Error run session on " << n << " node(s)" << std::endl;
+      return 1;
+    }
+    if (n == 1) {
+      single_node = runs_per_second;
+    }
+    std::cout << n << " node(s), " << tf_utils::NumaNodeCpus(n - 1).size() << " CPUs on the last one: "
+              << runs_per_second << " runs/s, scaling " << runs_per_second / single_node << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "partial_run.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+
+namespace tf_utils {
+
+std::unique_ptr<PartialRun> PartialRun::Setup(TF_Session* session,
+                                              const std::vector<TF_Output>& inputs, const std::vector<TF_Output>& outputs,
+                                              const std::vector<TF_Operation*>& targets,
+                                              TF_Status* status) {
+  if (session == nullptr) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  const char* handle = nullptr;
+  TF_SessionPRunSetup(session,
+                      inputs.data(), static_cast<int>(inputs.size()),
+                      outputs.data(), static_cast<int>(outputs.size()),
+                      targets.data(), static_cast<int>(targets.size()),
+                      &handle,
+                      status);
+  if (TF_GetCode(status) != TF_OK) {
+    TF_DeletePRunHandle(handle);
+    return nullptr;
+  }
+
+  return std::unique_ptr<PartialRun>{new PartialRun{session, handle}};
+}
+
+PartialRun::~PartialRun() {
+  TF_DeletePRunHandle(handle_);
+}
+
+TF_Code PartialRun::Run(const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                        const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+                        const std::vector<TF_Operation*>& targets,
+                        TF_Status* status) {
+  // Outputs left in the vector would leak when overwritten.
+  auto owned_output = std::find_if(output_tensors.begin(), output_tensors.end(), [](TF_Tensor* t) { return t != nullptr; });
+  if (inputs.size() != input_tensors.size() || owned_output != output_tensors.end()) {
+    if (status != nullptr) {
+      TF_SetStatus(status, TF_INVALID_ARGUMENT, inputs.size() != input_tensors.size()
+                                                    ? "Number of inputs and input tensors differ"
+                                                    : "Output tensors must be empty or null");
+    }
+    return TF_INVALID_ARGUMENT;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  output_tensors.assign(outputs.size(), nullptr);
+  TF_SessionPRun(session_, handle_,
+                 inputs.data(), input_tensors.data(), static_cast<int>(inputs.size()),
+                 outputs.data(), output_tensors.data(), static_cast<int>(outputs.size()),
+                 targets.data(), static_cast<int>(targets.size()),
+                 status);
+
+  return TF_GetCode(status);
+}
+
+TF_Code PartialRun::Feed(const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors, TF_Status* status) {
+  std::vector<TF_Tensor*> no_outputs;
+  return Run(inputs, input_tensors, {}, no_outputs, {}, status);
+}
+
+TF_Code PartialRun::Fetch(const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors, TF_Status* status) {
+  return Run({}, {}, outputs, output_tensors, {}, status);
+}
+
+} // namespace tf_utils
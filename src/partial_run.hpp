@@ -0,0 +1,65 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <memory>
+#include <vector>
+
+namespace tf_utils {
+
+// A staged run of one step: all feeds and fetches are declared up front, then inputs are fed and
+// outputs fetched as they become available. Every input is fed once and every output fetched once.
+class PartialRun {
+ public:
+  // `targets` are ops to run without fetching anything, e.g. an update op.
+  static std::unique_ptr<PartialRun> Setup(TF_Session* session,
+                                           const std::vector<TF_Output>& inputs, const std::vector<TF_Output>& outputs,
+                                           const std::vector<TF_Operation*>& targets = {},
+                                           TF_Status* status = nullptr);
+
+  ~PartialRun();
+
+  PartialRun(const PartialRun&) = delete;
+
+  PartialRun& operator=(const PartialRun&) = delete;
+
+  // Feeds some of the declared inputs and fetches the declared outputs that only need what was fed so far.
+  // `output_tensors` must be empty or all null, it is resized to `outputs` and the caller owns what is fetched.
+  TF_Code Run(const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+              const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+              const std::vector<TF_Operation*>& targets = {},
+              TF_Status* status = nullptr);
+
+  TF_Code Feed(const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors, TF_Status* status = nullptr);
+
+  TF_Code Fetch(const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors, TF_Status* status = nullptr);
+
+ private:
+  PartialRun(TF_Session* session, const char* handle) : session_{session}, handle_{handle} {}
+
+  TF_Session* session_;
+  const char* handle_;
+};
+
+} // namespace tf_utils
@@ -0,0 +1,239 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "placement.hpp"
+#include "session_options.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#  include <sched.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace tf_utils {
+
+namespace {
+
+#if defined(__linux__)
+// See linux/mempolicy.h, glibc has no wrappers for these syscalls.
+enum : int {
+  kMpolPreferred = 1,
+  kMpolBind = 2,
+};
+
+using NodeMask = std::vector<unsigned long>;
+
+static NodeMask MakeNodeMask(int numa_node) {
+  constexpr std::size_t kBits = sizeof(unsigned long) * 8;
+  NodeMask mask(static_cast<std::size_t>(numa_node) / kBits + 1, 0);
+  mask[static_cast<std::size_t>(numa_node) / kBits] |= 1UL << (static_cast<std::size_t>(numa_node) % kBits);
+  return mask;
+}
+
+// The kernel reads one bit less than `maxnode`.
+static unsigned long MaxNode(const NodeMask& mask) {
+  return mask.size() * sizeof(unsigned long) * 8 + 1;
+}
+
+static void UnmapTensor(void* data, std::size_t len, void*) {
+  munmap(data, len);
+}
+#endif
+
+// Parses a sysfs cpulist such as "0-3,8-11".
+static std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream ss{list};
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    auto dash = range.find('-');
+    auto first = std::atoi(range.c_str());
+    auto last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+static std::vector<int> PlacementCpus(const Placement& placement) {
+  if (!placement.cpus.empty()) {
+    return placement.cpus;
+  }
+  return NumaNodeCpus(placement.numa_node < 0 ? 0 : placement.numa_node);
+}
+
+} // namespace tf_utils::
+
+int NumaNodeCount() {
+  int count = 0;
+  while (std::ifstream{"/sys/devices/system/node/node" + std::to_string(count) + "/cpulist"}.is_open()) {
+    ++count;
+  }
+  return std::max(count, 1);
+}
+
+std::vector<int> NumaNodeCpus(int numa_node) {
+  std::ifstream f("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+  std::string list;
+  if (std::getline(f, list)) {
+    return ParseCpuList(list);
+  }
+
+  // No NUMA information, a single node with every CPU.
+  std::vector<int> cpus;
+  if (numa_node == 0) {
+    for (unsigned int cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); ++cpu) {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+  }
+  return cpus;
+}
+
+TF_Code BindCurrentThread(const Placement& placement, TF_Status* status) {
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+#if defined(__linux__)
+  auto cpus = PlacementCpus(placement);
+  if (cpus.empty()) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT, "Placement has no CPUs");
+    return TF_GetCode(status);
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    TF_SetStatus(status, TF_INVALID_ARGUMENT, "Can't set the CPU affinity");
+    return TF_GetCode(status);
+  }
+
+  // Preferred rather than bound, allocations still succeed when the node runs out of memory. Best effort
+  // like CreateTensorOnNode: without NUMA support or under a seccomp filter (ENOSYS, EPERM) only the
+  // affinity applies.
+  if (placement.numa_node >= 0) {
+    auto mask = MakeNodeMask(placement.numa_node);
+    syscall(SYS_set_mempolicy, kMpolPreferred, mask.data(), MaxNode(mask));
+  }
+
+  TF_SetStatus(status, TF_OK, "");
+  return TF_OK;
+#else
+  static_cast<void>(placement);
+  TF_SetStatus(status, TF_UNIMPLEMENTED, "Thread placement is only supported on Linux");
+  return TF_GetCode(status);
+#endif
+}
+
+TF_Session* CreatePlacedSession(TF_Graph* graph, const Placement& placement, const TF_SessionOptions* options, TF_Status* status) {
+  if (graph == nullptr) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  MAKE_SCOPE_EXIT(delete_options){ TF_DeleteSessionOptions(const_cast<TF_SessionOptions*>(options)); };
+  if (options == nullptr) {
+    auto num_threads = static_cast<std::int32_t>(PlacementCpus(placement).size());
+    options = SessionOptionsBuilder{}
+        .IntraOpParallelismThreads(num_threads)
+        .InterOpParallelismThreads(num_threads)
+        .UsePerSessionThreads(true)
+        .Build(status);
+    if (options == nullptr) {
+      return nullptr;
+    }
+  } else {
+    delete_options.dismiss();
+  }
+
+  // The binding stays with the helper thread, the caller's own placement is left alone.
+  TF_Session* session = nullptr;
+  std::thread creator{[&] {
+    if (BindCurrentThread(placement, status) == TF_OK) {
+      session = CreateSession(graph, options, status);
+    }
+  }};
+  creator.join();
+
+  return session;
+}
+
+TF_Tensor* CreateTensorOnNode(TF_DataType data_type,
+                              const std::int64_t* dims, std::size_t num_dims,
+                              const void* data, std::size_t len, int numa_node) {
+  if (dims == nullptr) {
+    return nullptr;
+  }
+
+#if defined(__linux__)
+  if (numa_node >= 0 && len > 0) {
+    auto buffer = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+      return nullptr;
+    }
+
+    // Bind before the first touch, so the pages are faulted in on the node. Without NUMA support
+    // the binding fails and the buffer is an ordinary one.
+    auto mask = MakeNodeMask(numa_node);
+    syscall(SYS_mbind, buffer, len, kMpolBind, mask.data(), MaxNode(mask), 0);
+
+    if (data != nullptr) {
+      std::memcpy(buffer, data, len);
+    }
+
+    // A failing TF_NewTensor has already run UnmapTensor on the buffer.
+    return TF_NewTensor(data_type, dims, static_cast<int>(num_dims), buffer, len, UnmapTensor, nullptr);
+  }
+#else
+  static_cast<void>(numa_node);
+#endif
+
+  return CreateTensor(data_type, dims, num_dims, data, len);
+}
+
+} // namespace tf_utils
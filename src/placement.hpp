@@ -0,0 +1,67 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tf_utils {
+
+struct Placement {
+  // CPUs the session's threads run on, empty for the CPUs of `numa_node`.
+  std::vector<int> cpus;
+  // Node the session's memory is allocated on, -1 to leave the memory policy alone.
+  int numa_node = -1;
+};
+
+// Number of NUMA nodes, 1 if the system reports none.
+int NumaNodeCount();
+
+std::vector<int> NumaNodeCpus(int numa_node);
+
+// Pins the calling thread to the placement's CPUs and makes it prefer the node's memory.
+// Threads it starts afterwards inherit both. Only the pinning can fail, the memory policy is
+// best effort here and in CreateTensorOnNode, as set_mempolicy and mbind may be unavailable.
+TF_Code BindCurrentThread(const Placement& placement, TF_Status* status = nullptr);
+
+// Creates the session from a thread bound to `placement`, so the per-session pools TensorFlow starts
+// there inherit the CPU set and memory policy. nullptr `options` give per-session pools as wide as
+// the CPU set. Intra-op pools are process-wide unless TF_OVERRIDE_GLOBAL_THREADPOOL=1 is set.
+TF_Session* CreatePlacedSession(TF_Graph* graph, const Placement& placement,
+                                const TF_SessionOptions* options = nullptr, TF_Status* status = nullptr);
+
+// Like CreateTensor, with the buffer bound to `numa_node` pages, for the large inputs of a placed session.
+TF_Tensor* CreateTensorOnNode(TF_DataType data_type,
+                              const std::int64_t* dims, std::size_t num_dims,
+                              const void* data, std::size_t len, int numa_node);
+
+template <typename T>
+TF_Tensor* CreateTensorOnNode(TF_DataType data_type, const std::vector<std::int64_t>& dims, const std::vector<T>& data, int numa_node) {
+  return CreateTensorOnNode(data_type,
+                            dims.data(), dims.size(),
+                            data.data(), data.size() * sizeof(T), numa_node);
+}
+
+} // namespace tf_utils
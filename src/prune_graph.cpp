@@ -0,0 +1,131 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <iostream>
+#include <vector>
+
+// Usage: prune_graph [graph.pb]
+
+static std::size_t CountOperations(TF_Graph* graph) {
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  while (TF_GraphNextOperation(graph, &pos) != nullptr) {
+    ++count;
+  }
+  return count;
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto full_graph = tf_utils::LoadGraph(graph_path, status);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(full_graph); };
+  if (full_graph == nullptr) {
+    std::cout << "Can't load graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  tf_utils::PruneStats stats;
+  tf_utils::LoadGraphOptions options;
+  options.feeds = {"input_4"};
+  options.fetches = {"output_node0"};
+  options.prune_stats = &stats;
+
+  auto graph = tf_utils::LoadGraph(graph_path, nullptr, options, status);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load pruned graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  std::cout << "Full graph: " << CountOperations(full_graph) << " ops" << std::endl;
+  std::cout << "Pruned graph: " << CountOperations(graph) << " ops, dropped " << stats.nodes_dropped
+            << " nodes, " << stats.bytes_dropped << " bytes" << std::endl;
+
+  // A fed op that isn't a Placeholder becomes one of its output type in the imported graph, its inputs are cut off.
+  tf_utils::PruneStats cut_stats;
+  tf_utils::LoadGraphOptions cut_options;
+  cut_options.feeds = {"sru_10/Sum"};
+  cut_options.fetches = {"output_node0"};
+  cut_options.prune_stats = &cut_stats;
+  auto cut_graph = tf_utils::LoadGraph(graph_path, nullptr, cut_options, status);
+  tf_utils::DeleteGraph(cut_graph);
+  if (cut_graph == nullptr || cut_stats.nodes_dropped <= stats.nodes_dropped) {
+    std::cout << "Fed op is not cut off: " << TF_Message(status) << std::endl;
+    return 2;
+  }
+
+  // Unpack has more outputs than a Placeholder and later ones are read, so feeding its first output cuts nothing.
+  tf_utils::PruneStats unpack_stats;
+  tf_utils::LoadGraphOptions unpack_options;
+  unpack_options.feeds = {"input_4", "sru_10/unstack:0"};
+  unpack_options.fetches = {"output_node0"};
+  unpack_options.prune_stats = &unpack_stats;
+  auto unpack_graph = tf_utils::LoadGraph(graph_path, nullptr, unpack_options, status);
+  tf_utils::DeleteGraph(unpack_graph);
+  if (unpack_graph == nullptr || unpack_stats.nodes_dropped != stats.nodes_dropped) {
+    std::cout << "Fed multi-output op is cut: " << TF_Message(status) << std::endl;
+    return 2;
+  }
+
+  options.fetches = {"missing_output:0"};
+  auto missing_graph = tf_utils::LoadGraph(graph_path, nullptr, options, status);
+  if (missing_graph != nullptr || TF_GetCode(status) != TF_NOT_FOUND) {
+    tf_utils::DeleteGraph(missing_graph);
+    std::cout << "Missing fetch is not reported" << std::endl;
+    return 2;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  if (code != TF_OK) {
+    std::cout << "Error run session TF_CODE: " << code;
+    return code;
+  }
+
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  return 0;
+}
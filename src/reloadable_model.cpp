@@ -0,0 +1,136 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "reloadable_model.hpp"
+#include <scope_guard.hpp>
+#include <utility>
+
+namespace tf_utils {
+
+ReloadableModel::ReloadableModel(std::string graph_path, ReloadOptions options)
+    : graph_path_{std::move(graph_path)},
+      options_{std::move(options)} {
+}
+
+ReloadableModel::~ReloadableModel() {
+  Stop();
+}
+
+TF_Code ReloadableModel::Start(TF_Status* status) {
+  auto code = Reload(status);
+  if (code != TF_OK) {
+    return code;
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (!watcher_.joinable()) {
+    stop_ = false;
+    watcher_ = std::thread{&ReloadableModel::WatchLoop, this};
+  }
+
+  return TF_OK;
+}
+
+void ReloadableModel::Stop() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  cv_.notify_all();
+
+  if (watcher_.joinable()) {
+    watcher_.join();
+  }
+}
+
+TF_Code ReloadableModel::Reload(TF_Status* status) {
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  std::lock_guard<std::mutex> reload_lock{reload_mutex_};
+  auto current = Get();
+
+  // A file that failed to load, create a session or warm up is not read again until it changes.
+  std::string path;
+  std::int64_t mtime = -1;
+  std::int64_t size = -1;
+  StatFile(graph_path_.c_str(), &path, &mtime, &size);
+  if (failed_code_ != TF_OK && mtime == failed_mtime_ && size == failed_size_) {
+    TF_SetStatus(status, failed_code_, "Model file is unchanged since its load failed");
+    return failed_code_;
+  }
+  auto remember_failure = [&](TF_Code code) {
+    failed_mtime_ = mtime;
+    failed_size_ = size;
+    failed_code_ = code;
+    return code;
+  };
+
+  // The registry keys graphs on modification time and size, so an unchanged file returns the current graph.
+  auto graph = ModelRegistry::Instance().GetGraph(graph_path_.c_str(), options_.load_options, status);
+  if (graph == nullptr) {
+    return remember_failure(TF_GetCode(status));
+  }
+  failed_code_ = TF_OK;
+  if (current != nullptr && current->graph == graph) {
+    TF_SetStatus(status, TF_OK, "");
+    return TF_OK;
+  }
+
+  auto session = CreateSession(graph, options_.session_options, status);
+  if (session == nullptr) {
+    return remember_failure(TF_GetCode(status));
+  }
+
+  if (options_.warmup) {
+    auto code = options_.warmup(session.get(), graph.get());
+    if (code != TF_OK) {
+      TF_SetStatus(status, code, "Model warm-up failed");
+      return remember_failure(code);
+    }
+  }
+
+  auto next = std::make_shared<ModelVersion>();
+  next->graph = std::move(graph);
+  next->session = std::move(session);
+  next->version = current != nullptr ? current->version + 1 : 1;
+  std::atomic_store(&current_, std::shared_ptr<const ModelVersion>{std::move(next)});
+
+  TF_SetStatus(status, TF_OK, "");
+  return TF_OK;
+}
+
+void ReloadableModel::WatchLoop() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (!cv_.wait_for(lock, options_.poll_interval, [this] { return stop_; })) {
+    lock.unlock();
+    // A failed load keeps the current version.
+    Reload();
+    lock.lock();
+  }
+}
+
+} // namespace tf_utils
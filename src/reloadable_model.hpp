@@ -0,0 +1,96 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "model_registry.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace tf_utils {
+
+// One loaded version of a model, runs keep it alive while they use it.
+struct ModelVersion {
+  GraphHandle graph;
+  SessionHandle session;
+  std::uint64_t version = 0;
+};
+
+struct ReloadOptions {
+  LoadGraphOptions load_options;
+  // Not owned, nullptr for the default session options.
+  const TF_SessionOptions* session_options = nullptr;
+  std::chrono::milliseconds poll_interval{1000};
+  // Runs on every new session before it is swapped in, a version that fails it is dropped.
+  std::function<TF_Code(TF_Session*, TF_Graph*)> warmup;
+};
+
+// Model that watches its GraphDef file and, when it changes, loads and warms up the new version in a
+// background thread before swapping it in. Runs that already hold the old version finish on it,
+// it is freed when the last of them lets go. Replace the file atomically (write and rename),
+// a partially written file fails to load. A file that failed is only tried again once it changes.
+class ReloadableModel {
+ public:
+  explicit ReloadableModel(std::string graph_path, ReloadOptions options = ReloadOptions{});
+
+  ~ReloadableModel();
+
+  ReloadableModel(const ReloadableModel&) = delete;
+
+  ReloadableModel& operator=(const ReloadableModel&) = delete;
+
+  // Loads the first version and starts watching the file.
+  TF_Code Start(TF_Status* status = nullptr);
+
+  void Stop();
+
+  // Loads the file now if it changed since the current version was loaded or the last load failed.
+  TF_Code Reload(TF_Status* status = nullptr);
+
+  // Current version, nullptr before the first successful load. Hold it for the whole run.
+  std::shared_ptr<const ModelVersion> Get() const { return std::atomic_load(&current_); }
+
+ private:
+  void WatchLoop();
+
+  const std::string graph_path_;
+  const ReloadOptions options_;
+  std::shared_ptr<const ModelVersion> current_;
+  std::mutex reload_mutex_;
+  // Modification time and size of the file at the last failed load, guarded by reload_mutex_.
+  std::int64_t failed_mtime_ = -1;
+  std::int64_t failed_size_ = -1;
+  TF_Code failed_code_ = TF_OK;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::thread watcher_;
+};
+
+} // namespace tf_utils
@@ -0,0 +1,87 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#  error "run_awaitable.hpp needs C++20 coroutines, configure with -DTF_UTILS_WITH_COROUTINES=ON"
+#endif
+
+#include "async_session.hpp"
+#include <coroutine>
+#include <utility>
+#include <vector>
+
+namespace tf_utils {
+
+// `co_await` suspends the coroutine, runs the session on `executor` (DefaultRunExecutor if null)
+// and resumes it on `resume_on`, or on the thread that ran the session if null.
+// The session and input tensors must stay alive until the coroutine resumes.
+class RunAwaitable {
+ public:
+  RunAwaitable(TF_Session* session,
+               std::vector<TF_Output> inputs, std::vector<TF_Tensor*> input_tensors,
+               std::vector<TF_Output> outputs,
+               ThreadPool* executor = nullptr, ThreadPool* resume_on = nullptr)
+      : session_{session},
+        inputs_{std::move(inputs)},
+        input_tensors_{std::move(input_tensors)},
+        outputs_{std::move(outputs)},
+        executor_{executor},
+        resume_on_{resume_on} {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    // The coroutine may resume before RunSessionAsync returns, nothing of *this is touched afterwards.
+    RunSessionAsync(session_, inputs_, input_tensors_, outputs_,
+                    [this, handle](RunResult result) {
+                      result_ = std::move(result);
+                      if (resume_on_ != nullptr) {
+                        resume_on_->Schedule([handle] { handle.resume(); });
+                      } else {
+                        handle.resume();
+                      }
+                    },
+                    executor_);
+  }
+
+  RunResult await_resume() noexcept { return std::move(result_); }
+
+ private:
+  TF_Session* session_;
+  std::vector<TF_Output> inputs_;
+  std::vector<TF_Tensor*> input_tensors_;
+  std::vector<TF_Output> outputs_;
+  ThreadPool* executor_;
+  ThreadPool* resume_on_;
+  RunResult result_;
+};
+
+inline RunAwaitable RunSessionAwait(TF_Session* session,
+                                    std::vector<TF_Output> inputs, std::vector<TF_Tensor*> input_tensors,
+                                    std::vector<TF_Output> outputs,
+                                    ThreadPool* executor = nullptr, ThreadPool* resume_on = nullptr) {
+  return {session, std::move(inputs), std::move(input_tensors), std::move(outputs), executor, resume_on};
+}
+
+} // namespace tf_utils
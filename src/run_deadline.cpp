@@ -0,0 +1,140 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Usage: run_deadline [graph.pb] [deadline ms]
+
+// A dequeue from a FIFO queue nothing is ever enqueued to, a step that blocks until it is stopped.
+static TF_Operation* AddBlockingDequeue(TF_Graph* graph, TF_Status* status) {
+  const TF_DataType component_types[] = {TF_FLOAT};
+  auto desc = TF_NewOperation(graph, "FIFOQueueV2", "queue");
+  TF_SetAttrTypeList(desc, "component_types", component_types, 1);
+  auto queue = TF_FinishOperation(desc, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return nullptr;
+  }
+
+  desc = TF_NewOperation(graph, "QueueDequeueV2", "dequeue");
+  TF_AddInput(desc, {queue, 0});
+  TF_SetAttrTypeList(desc, "component_types", component_types, 1);
+  return TF_FinishOperation(desc, status);
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  const std::chrono::milliseconds deadline_ms{argc > 2 ? std::atoi(argv[2]) : 1000};
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<TF_Output> inputs = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Output> outputs = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = tf_utils::RunSession(session, inputs, input_tensors, outputs, output_tensors,
+                                   std::chrono::steady_clock::now() + deadline_ms, status);
+  if (code != TF_OK) {
+    std::cout << "Run within " << deadline_ms.count() << " ms failed: " << tf_utils::CodeToString(code) << " " << TF_Message(status) << std::endl;
+    return code;
+  }
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  // A request that waited in a queue past its deadline is shed without running.
+  std::vector<TF_Tensor*> late_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(late_tensors); };
+  code = tf_utils::RunSession(session, inputs, input_tensors, outputs, late_tensors,
+                              std::chrono::steady_clock::now() - std::chrono::milliseconds{1}, status);
+  std::cout << "Late run: " << tf_utils::CodeToString(code) << std::endl;
+  if (code != TF_DEADLINE_EXCEEDED) {
+    return 2;
+  }
+
+  // A run that started in time but blocks is stopped by the RunOptions timeout.
+  auto queue_graph = TF_NewGraph();
+  SCOPE_EXIT{ tf_utils::DeleteGraph(queue_graph); };
+  auto dequeue = AddBlockingDequeue(queue_graph, status);
+  if (dequeue == nullptr) {
+    std::cout << "Can't build queue graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  auto queue_session = tf_utils::CreateSession(queue_graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(queue_session); };
+  if (queue_session == nullptr) {
+    std::cout << "Can't create queue session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<TF_Output> no_inputs;
+  const std::vector<TF_Tensor*> no_input_tensors;
+  std::vector<TF_Tensor*> blocked_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(blocked_tensors); };
+  const std::chrono::milliseconds blocked_ms{100};
+  auto start = std::chrono::steady_clock::now();
+  code = tf_utils::RunSession(queue_session, no_inputs, no_input_tensors, {{dequeue, 0}}, blocked_tensors,
+                              start + blocked_ms, status);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << "Blocked run: " << tf_utils::CodeToString(code) << " after " << elapsed.count() << " ms" << std::endl;
+  if (code != TF_DEADLINE_EXCEEDED || elapsed < blocked_ms / 2) {
+    return 3;
+  }
+
+  // Aborting fails the runs in flight and every later one.
+  tf_utils::AbortSession(session, status);
+  std::vector<TF_Tensor*> aborted_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(aborted_tensors); };
+  code = tf_utils::RunSession(session, inputs, input_tensors, outputs, aborted_tensors, status);
+  std::cout << "Run after abort: " << tf_utils::CodeToString(code) << std::endl;
+  if (code == TF_OK) {
+    return 2;
+  }
+
+  return 0;
+}
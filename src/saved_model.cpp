@@ -0,0 +1,226 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "saved_model.hpp"
+#include "model_signature.hpp"
+#include "wire_format.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace tf_utils {
+
+namespace {
+
+// Field numbers, see tensorflow/core/protobuf/meta_graph.proto.
+enum : std::uint32_t {
+  kMetaGraphDefSignatureDef = 5,
+
+  kMapEntryKey = 1,
+  kMapEntryValue = 2,
+
+  kSignatureDefInputs = 1,
+  kSignatureDefOutputs = 2,
+  kSignatureDefMethodName = 3,
+
+  kTensorInfoName = 1,
+  kTensorInfoDtype = 2,
+};
+
+struct TensorInfo {
+  std::string name;
+  TF_DataType dtype = static_cast<TF_DataType>(0);
+};
+
+struct SignatureDef {
+  std::string method_name;
+  std::map<std::string, TensorInfo> inputs;
+  std::map<std::string, TensorInfo> outputs;
+};
+
+// Splits a map<string, Message> entry into its key and serialized value.
+static bool ParseMapEntry(const char* data, std::size_t size, std::string* key, std::string* value) {
+  wire::Reader entry{data, size};
+  while (entry.Next()) {
+    if (entry.field() == kMapEntryKey) {
+      *key = entry.str();
+    } else if (entry.field() == kMapEntryValue) {
+      *value = entry.str();
+    }
+  }
+  return entry.ok();
+}
+
+static bool ParseTensorInfo(const std::string& data, TensorInfo* info) {
+  wire::Reader reader{data};
+  while (reader.Next()) {
+    if (reader.field() == kTensorInfoName) {
+      info->name = reader.str();
+    } else if (reader.field() == kTensorInfoDtype) {
+      info->dtype = static_cast<TF_DataType>(reader.value());
+    }
+  }
+  return reader.ok();
+}
+
+static bool ParseSignatureDef(const std::string& data, SignatureDef* signature) {
+  wire::Reader reader{data};
+  while (reader.Next()) {
+    if (reader.field() == kSignatureDefMethodName) {
+      signature->method_name = reader.str();
+      continue;
+    }
+    if (reader.field() != kSignatureDefInputs && reader.field() != kSignatureDefOutputs) {
+      continue;
+    }
+
+    std::string key;
+    std::string value;
+    TensorInfo info;
+    if (!ParseMapEntry(reader.data(), reader.size(), &key, &value) || !ParseTensorInfo(value, &info)) {
+      return false;
+    }
+    auto& tensors = reader.field() == kSignatureDefInputs ? signature->inputs : signature->outputs;
+    tensors[key] = std::move(info);
+  }
+  return reader.ok();
+}
+
+static bool ResolveTensors(TF_Graph* graph, const std::map<std::string, TensorInfo>& infos,
+                           std::vector<std::string>* keys, std::vector<TF_Output>* outputs,
+                           std::vector<TF_DataType>* types, TF_Status* status) {
+  for (auto& i : infos) {
+    if (i.second.name.empty()) {
+      TF_SetStatus(status, TF_UNIMPLEMENTED, ("Signature tensor " + i.first + " is not a dense tensor").c_str());
+      return false;
+    }
+    auto output = ResolveOutput(graph, i.second.name, status);
+    if (output.oper == nullptr) {
+      return false;
+    }
+    keys->push_back(i.first);
+    outputs->push_back(output);
+    types->push_back(i.second.dtype);
+  }
+  return true;
+}
+
+static int FindKey(const std::vector<std::string>& keys, const std::string& key) {
+  auto it = std::find(keys.begin(), keys.end(), key);
+  return it == keys.end() ? -1 : static_cast<int>(it - keys.begin());
+}
+
+} // namespace tf_utils::
+
+int Signature::InputIndex(const std::string& key) const {
+  return FindKey(input_keys, key);
+}
+
+int Signature::OutputIndex(const std::string& key) const {
+  return FindKey(output_keys, key);
+}
+
+const Signature* SavedModel::FindSignature(const std::string& name) const {
+  auto it = signatures.find(name);
+  return it == signatures.end() ? nullptr : &it->second;
+}
+
+SavedModel* LoadSavedModel(const char* export_dir, const std::vector<std::string>& tags,
+                           const TF_SessionOptions* options, TF_Status* status) {
+  if (export_dir == nullptr) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  MAKE_SCOPE_EXIT(delete_options){ TF_DeleteSessionOptions(const_cast<TF_SessionOptions*>(options)); };
+  if (options == nullptr) {
+    options = TF_NewSessionOptions();
+  } else {
+    delete_options.dismiss();
+  }
+
+  std::vector<const char*> tag_names;
+  for (auto& t : tags) {
+    tag_names.push_back(t.c_str());
+  }
+
+  auto model = new SavedModel;
+  MAKE_SCOPE_EXIT(delete_model){ DeleteSavedModel(model); };
+  auto meta_graph_def = TF_NewBuffer();
+  SCOPE_EXIT{ TF_DeleteBuffer(meta_graph_def); };
+
+  model->graph = TF_NewGraph();
+  model->session = TF_LoadSessionFromSavedModel(options, nullptr, export_dir,
+                                                tag_names.data(), static_cast<int>(tag_names.size()),
+                                                model->graph, meta_graph_def, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return nullptr;
+  }
+
+  wire::Reader reader{meta_graph_def->data, meta_graph_def->length};
+  while (reader.Next()) {
+    if (reader.field() != kMetaGraphDefSignatureDef) {
+      continue;
+    }
+
+    std::string name;
+    std::string value;
+    SignatureDef signature_def;
+    if (!ParseMapEntry(reader.data(), reader.size(), &name, &value) || !ParseSignatureDef(value, &signature_def)) {
+      TF_SetStatus(status, TF_DATA_LOSS, "Malformed MetaGraphDef");
+      return nullptr;
+    }
+
+    auto& signature = model->signatures[name];
+    signature.method_name = std::move(signature_def.method_name);
+    if (!ResolveTensors(model->graph, signature_def.inputs,
+                        &signature.input_keys, &signature.inputs, &signature.input_types, status) ||
+        !ResolveTensors(model->graph, signature_def.outputs,
+                        &signature.output_keys, &signature.outputs, &signature.output_types, status)) {
+      return nullptr;
+    }
+  }
+
+  if (!reader.ok()) {
+    TF_SetStatus(status, TF_DATA_LOSS, "Malformed MetaGraphDef");
+    return nullptr;
+  }
+
+  delete_model.dismiss();
+  return model;
+}
+
+void DeleteSavedModel(SavedModel* model) {
+  if (model == nullptr) {
+    return;
+  }
+  DeleteSession(model->session);
+  DeleteGraph(model->graph);
+  delete model;
+}
+
+} // namespace tf_utils
@@ -0,0 +1,67 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tf_utils {
+
+// SignatureDef with its tensors resolved against the loaded graph. The TF_Outputs are in key order,
+// ready to be passed to RunSession without any lookup by name.
+struct Signature {
+  std::string method_name;
+
+  std::vector<std::string> input_keys;
+  std::vector<TF_Output> inputs;
+  std::vector<TF_DataType> input_types;
+
+  std::vector<std::string> output_keys;
+  std::vector<TF_Output> outputs;
+  std::vector<TF_DataType> output_types;
+
+  // Position of `key` in inputs/outputs, -1 if the signature has no such tensor.
+  int InputIndex(const std::string& key) const;
+
+  int OutputIndex(const std::string& key) const;
+};
+
+struct SavedModel {
+  TF_Graph* graph = nullptr;
+  TF_Session* session = nullptr; // Variables are restored.
+  std::map<std::string, Signature> signatures;
+
+  // nullptr if the MetaGraphDef has no such signature.
+  const Signature* FindSignature(const std::string& name = "serving_default") const;
+};
+
+// Loads the MetaGraphDef tagged with `tags` from a SavedModel directory and resolves all its signatures.
+// Delete the result with DeleteSavedModel.
+SavedModel* LoadSavedModel(const char* export_dir, const std::vector<std::string>& tags = {"serve"},
+                           const TF_SessionOptions* options = nullptr, TF_Status* status = nullptr);
+
+void DeleteSavedModel(SavedModel* model);
+
+} // namespace tf_utils
@@ -0,0 +1,67 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "saved_model.hpp"
+#include <scope_guard.hpp>
+#include <iostream>
+
+// Usage: saved_model_info [export_dir] [tag]
+
+int main(int argc, char* argv[]) {
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  if (argc < 2) {
+    // Without an export directory only check that a missing SavedModel is reported.
+    auto model = tf_utils::LoadSavedModel("missing_saved_model", {"serve"}, nullptr, status);
+    if (model != nullptr || TF_GetCode(status) == TF_OK) {
+      tf_utils::DeleteSavedModel(model);
+      std::cout << "Missing SavedModel is not reported" << std::endl;
+      return 2;
+    }
+    std::cout << "Usage: saved_model_info export_dir [tag]" << std::endl;
+    return 0;
+  }
+
+  auto model = tf_utils::LoadSavedModel(argv[1], {argc > 2 ? argv[2] : "serve"}, nullptr, status);
+  SCOPE_EXIT{ tf_utils::DeleteSavedModel(model); };
+  if (model == nullptr) {
+    std::cout << "Can't load SavedModel: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  for (auto& s : model->signatures) {
+    std::cout << "Signature " << s.first << " (" << s.second.method_name << ")" << std::endl;
+    for (std::size_t i = 0; i < s.second.inputs.size(); ++i) {
+      auto& input = s.second.inputs[i];
+      std::cout << "  input " << s.second.input_keys[i] << ": " << TF_OperationName(input.oper) << ":" << input.index
+                << " " << tf_utils::DataTypeToString(s.second.input_types[i]) << std::endl;
+    }
+    for (std::size_t i = 0; i < s.second.outputs.size(); ++i) {
+      auto& output = s.second.outputs[i];
+      std::cout << "  output " << s.second.output_keys[i] << ": " << TF_OperationName(output.oper) << ":" << output.index
+                << " " << tf_utils::DataTypeToString(s.second.output_types[i]) << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "session_options.hpp"
+#include "wire_format.hpp"
+#include <scope_guard.hpp>
+#include <mutex>
+
+namespace tf_utils {
+
+namespace {
+
+// RewriterConfig.Toggle values.
+enum : std::uint64_t {
+  kToggleOn = 1,
+  kToggleOff = 2,
+};
+
+std::mutex default_config_mutex;
+std::string default_config;
+
+} // namespace tf_utils::
+
+SessionOptionsBuilder& SessionOptionsBuilder::DeviceCount(std::string device_type, std::int32_t count) {
+  device_count_.emplace_back(std::move(device_type), count);
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::IntraOpParallelismThreads(std::int32_t num_threads) {
+  intra_op_parallelism_threads_ = num_threads;
+  has_intra_op_parallelism_threads_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::InterOpParallelismThreads(std::int32_t num_threads) {
+  inter_op_parallelism_threads_ = num_threads;
+  has_inter_op_parallelism_threads_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::GpuMemoryFraction(double fraction) {
+  gpu_memory_fraction_ = fraction;
+  has_gpu_memory_fraction_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::AllowGrowth(bool allow_growth) {
+  allow_growth_ = allow_growth;
+  has_allow_growth_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::AllowSoftPlacement(bool allow_soft_placement) {
+  allow_soft_placement_ = allow_soft_placement;
+  has_allow_soft_placement_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::UsePerSessionThreads(bool use_per_session_threads) {
+  use_per_session_threads_ = use_per_session_threads;
+  has_use_per_session_threads_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::OptimizerLevel(tf_utils::OptimizerLevel level) {
+  optimizer_level_ = level;
+  has_optimizer_level_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::ConstantFolding(bool constant_folding) {
+  constant_folding_ = constant_folding;
+  has_constant_folding_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::OperationTimeoutInMs(std::int64_t timeout_ms) {
+  operation_timeout_in_ms_ = timeout_ms;
+  has_operation_timeout_in_ms_ = true;
+  return *this;
+}
+
+SessionOptionsBuilder& SessionOptionsBuilder::SessionInterOpThreadPool(std::int32_t num_threads, std::string global_name) {
+  session_inter_op_thread_pools_.emplace_back(num_threads, std::move(global_name));
+  return *this;
+}
+
+std::string SessionOptionsBuilder::Serialize() const {
+  // Fields are written in field number order, like the protobuf serializer does.
+  wire::Writer config;
+  for (auto& d : device_count_) {
+    wire::Writer entry;
+    entry.Bytes(1, d.first);
+    entry.Int64(2, d.second);
+    config.Bytes(kConfigDeviceCount, entry.str());
+  }
+  if (has_intra_op_parallelism_threads_) {
+    config.Int64(kConfigIntraOpParallelismThreads, intra_op_parallelism_threads_);
+  }
+  if (has_inter_op_parallelism_threads_) {
+    config.Int64(kConfigInterOpParallelismThreads, inter_op_parallelism_threads_);
+  }
+  if (has_gpu_memory_fraction_ || has_allow_growth_) {
+    wire::Writer gpu_options;
+    if (has_gpu_memory_fraction_) {
+      gpu_options.Double(kGpuOptionsPerProcessGpuMemoryFraction, gpu_memory_fraction_);
+    }
+    if (has_allow_growth_) {
+      gpu_options.Bool(kGpuOptionsAllowGrowth, allow_growth_);
+    }
+    config.Bytes(kConfigGpuOptions, gpu_options.str());
+  }
+  if (has_allow_soft_placement_) {
+    config.Bool(kConfigAllowSoftPlacement, allow_soft_placement_);
+  }
+  if (has_use_per_session_threads_) {
+    config.Bool(kConfigUsePerSessionThreads, use_per_session_threads_);
+  }
+  if (has_optimizer_level_ || has_constant_folding_) {
+    wire::Writer graph_options;
+    if (has_optimizer_level_) {
+      wire::Writer optimizer_options;
+      optimizer_options.Int64(kOptimizerOptionsOptLevel, static_cast<std::int64_t>(optimizer_level_));
+      graph_options.Bytes(kGraphOptionsOptimizerOptions, optimizer_options.str());
+    }
+    if (has_constant_folding_) {
+      wire::Writer rewrite_options;
+      rewrite_options.Varint(kRewriterConfigConstantFolding, constant_folding_ ? kToggleOn : kToggleOff);
+      graph_options.Bytes(kGraphOptionsRewriteOptions, rewrite_options.str());
+    }
+    config.Bytes(kConfigGraphOptions, graph_options.str());
+  }
+  if (has_operation_timeout_in_ms_) {
+    config.Int64(kConfigOperationTimeoutInMs, operation_timeout_in_ms_);
+  }
+  for (auto& p : session_inter_op_thread_pools_) {
+    wire::Writer pool;
+    pool.Int64(kThreadPoolOptionNumThreads, p.first);
+    if (!p.second.empty()) {
+      pool.Bytes(kThreadPoolOptionGlobalName, p.second);
+    }
+    config.Bytes(kConfigSessionInterOpThreadPool, pool.str());
+  }
+
+  return std::move(config.str());
+}
+
+TF_SessionOptions* SessionOptionsBuilder::Build(TF_Status* status) const {
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto config = Serialize();
+  auto options = TF_NewSessionOptions();
+  TF_SetConfig(options, config.data(), config.size(), status);
+
+  if (TF_GetCode(status) != TF_OK) {
+    TF_DeleteSessionOptions(options);
+    return nullptr;
+  }
+
+  return options;
+}
+
+std::string SerializeRunOptions(std::int64_t timeout_in_ms) {
+  wire::Writer writer;
+  if (timeout_in_ms > 0) {
+    writer.Int64(kRunOptionsTimeoutInMs, timeout_in_ms);
+  }
+  return writer.str();
+}
+
+void SetDefaultSessionConfig(std::string config) {
+  std::lock_guard<std::mutex> lock{default_config_mutex};
+  default_config = std::move(config);
+}
+
+std::string DefaultSessionConfig() {
+  std::lock_guard<std::mutex> lock{default_config_mutex};
+  return default_config;
+}
+
+} // namespace tf_utils
@@ -0,0 +1,136 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <c_api.h> // TensorFlow C API header
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tf_utils {
+
+// Field numbers, see tensorflow/core/protobuf/config.proto and rewriter_config.proto.
+enum : std::uint32_t {
+  kConfigDeviceCount = 1,
+  kConfigIntraOpParallelismThreads = 2,
+  kConfigInterOpParallelismThreads = 5,
+  kConfigGpuOptions = 6,
+  kConfigAllowSoftPlacement = 7,
+  kConfigUsePerSessionThreads = 9,
+  kConfigGraphOptions = 10,
+  kConfigOperationTimeoutInMs = 11,
+  kConfigSessionInterOpThreadPool = 12,
+
+  kGpuOptionsPerProcessGpuMemoryFraction = 1,
+  kGpuOptionsAllowGrowth = 4,
+
+  kGraphOptionsOptimizerOptions = 3,
+  kGraphOptionsRewriteOptions = 10,
+
+  kOptimizerOptionsOptLevel = 3,
+
+  kRewriterConfigConstantFolding = 3,
+
+  kThreadPoolOptionNumThreads = 1,
+  kThreadPoolOptionGlobalName = 2,
+
+  kRunOptionsTimeoutInMs = 2,
+};
+
+enum class OptimizerLevel : std::int64_t {
+  kL1 = 0, // Common subexpression elimination and constant folding, the default.
+  kL0 = -1, // No graph optimizations.
+};
+
+// Builds the serialized ConfigProto of TF_SetConfig, only the fields that were set are written.
+class SessionOptionsBuilder {
+ public:
+  // Maximum number of devices of a type, e.g. DeviceCount("GPU", 0) to run on the CPU only.
+  SessionOptionsBuilder& DeviceCount(std::string device_type, std::int32_t count);
+
+  SessionOptionsBuilder& IntraOpParallelismThreads(std::int32_t num_threads);
+
+  SessionOptionsBuilder& InterOpParallelismThreads(std::int32_t num_threads);
+
+  SessionOptionsBuilder& GpuMemoryFraction(double fraction);
+
+  SessionOptionsBuilder& AllowGrowth(bool allow_growth);
+
+  SessionOptionsBuilder& AllowSoftPlacement(bool allow_soft_placement);
+
+  // Give the session its own inter-op thread pool instead of the process-wide one.
+  SessionOptionsBuilder& UsePerSessionThreads(bool use_per_session_threads);
+
+  SessionOptionsBuilder& OptimizerLevel(tf_utils::OptimizerLevel level);
+
+  SessionOptionsBuilder& ConstantFolding(bool constant_folding);
+
+  // Deadline of blocking operations such as queue dequeues, 0 for none.
+  SessionOptionsBuilder& OperationTimeoutInMs(std::int64_t timeout_ms);
+
+  // Adds an inter-op pool the session runs its ops on instead of its own one. Pools with a `global_name`
+  // are created once per process and shared by every session naming them, all with the same size.
+  SessionOptionsBuilder& SessionInterOpThreadPool(std::int32_t num_threads, std::string global_name = {});
+
+  // Serialized ConfigProto.
+  std::string Serialize() const;
+
+  TF_SessionOptions* Build(TF_Status* status = nullptr) const;
+
+ private:
+  std::vector<std::pair<std::string, std::int32_t>> device_count_;
+  std::int32_t intra_op_parallelism_threads_ = 0;
+  std::int32_t inter_op_parallelism_threads_ = 0;
+  double gpu_memory_fraction_ = 0.0;
+  bool allow_growth_ = false;
+  bool allow_soft_placement_ = false;
+  bool use_per_session_threads_ = false;
+  tf_utils::OptimizerLevel optimizer_level_ = tf_utils::OptimizerLevel::kL1;
+  bool constant_folding_ = true;
+  std::int64_t operation_timeout_in_ms_ = 0;
+  std::vector<std::pair<std::int32_t, std::string>> session_inter_op_thread_pools_;
+
+  bool has_intra_op_parallelism_threads_ = false;
+  bool has_inter_op_parallelism_threads_ = false;
+  bool has_gpu_memory_fraction_ = false;
+  bool has_allow_growth_ = false;
+  bool has_allow_soft_placement_ = false;
+  bool has_use_per_session_threads_ = false;
+  bool has_optimizer_level_ = false;
+  bool has_constant_folding_ = false;
+  bool has_operation_timeout_in_ms_ = false;
+};
+
+// Serialized RunOptions of TF_SessionRun. A positive `timeout_in_ms` makes TensorFlow cancel the step
+// with DEADLINE_EXCEEDED once it has run that long.
+std::string SerializeRunOptions(std::int64_t timeout_in_ms);
+
+// Config of the sessions CreateSession(graph) creates without explicit options, e.g. with a shared
+// SessionInterOpThreadPool so that all the models of a process run on the same threads.
+// An empty config restores TensorFlow's defaults.
+void SetDefaultSessionConfig(std::string config);
+
+std::string DefaultSessionConfig();
+
+} // namespace tf_utils
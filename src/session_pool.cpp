@@ -0,0 +1,132 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "session_pool.hpp"
+#include "session_options.hpp"
+#include <scope_guard.hpp>
+#include <utility>
+
+namespace tf_utils {
+
+SessionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_{other.pool_},
+      session_{other.session_} {
+  other.pool_ = nullptr;
+  other.session_ = nullptr;
+}
+
+SessionPool::Lease& SessionPool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    if (session_ != nullptr) {
+      pool_->Return(session_);
+    }
+    pool_ = other.pool_;
+    session_ = other.session_;
+    other.pool_ = nullptr;
+    other.session_ = nullptr;
+  }
+  return *this;
+}
+
+SessionPool::Lease::~Lease() {
+  if (session_ != nullptr) {
+    pool_->Return(session_);
+  }
+}
+
+std::unique_ptr<SessionPool> SessionPool::Create(GraphHandle graph, const SessionPoolOptions& options, TF_Status* status) {
+  if (graph == nullptr || options.num_sessions == 0) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  // Per-session threads unless a shared pool is named, otherwise every session would use the default pools.
+  SessionOptionsBuilder builder;
+  builder.IntraOpParallelismThreads(options.intra_op_threads).InterOpParallelismThreads(options.inter_op_threads);
+  if (options.inter_op_pool_name.empty()) {
+    builder.UsePerSessionThreads(true);
+  } else {
+    builder.SessionInterOpThreadPool(options.inter_op_threads, options.inter_op_pool_name);
+  }
+  auto session_options = builder.Build(status);
+  if (session_options == nullptr) {
+    return nullptr;
+  }
+  SCOPE_EXIT{ TF_DeleteSessionOptions(session_options); };
+
+  std::unique_ptr<SessionPool> pool{new SessionPool{std::move(graph)}};
+  for (std::size_t i = 0; i < options.num_sessions; ++i) {
+    auto session = CreateSession(pool->graph_, session_options, status);
+    if (session == nullptr) {
+      return nullptr;
+    }
+    pool->free_.push_back(session.get());
+    pool->sessions_.push_back(std::move(session));
+  }
+
+  return pool;
+}
+
+SessionPool::Lease SessionPool::Checkout(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  if (!cv_.wait_for(lock, timeout, [this] { return !free_.empty(); })) {
+    return {};
+  }
+
+  auto session = free_.back();
+  free_.pop_back();
+  return {this, session};
+}
+
+void SessionPool::Return(TF_Session* session) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    free_.push_back(session);
+  }
+  cv_.notify_one();
+}
+
+TF_Code SessionPool::Run(const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                         const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+                         std::chrono::milliseconds timeout, TF_Status* status) {
+  auto lease = Checkout(timeout);
+  if (!lease) {
+    if (status != nullptr) {
+      TF_SetStatus(status, TF_RESOURCE_EXHAUSTED, "No free session in the pool");
+    }
+    return TF_RESOURCE_EXHAUSTED;
+  }
+
+  return RunSession(lease.get(), inputs, input_tensors, outputs, output_tensors, status);
+}
+
+std::size_t SessionPool::available() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return free_.size();
+}
+
+} // namespace tf_utils
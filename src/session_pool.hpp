@@ -0,0 +1,110 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "model_registry.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tf_utils {
+
+struct SessionPoolOptions {
+  std::size_t num_sessions = 1;
+  // Threads of each session's own pools, 0 lets TensorFlow pick one per core. In TF 1.x the intra-op pool
+  // is process-wide and sized by the first session created, unless TF_OVERRIDE_GLOBAL_THREADPOOL=1 is set
+  // before it, so without that variable only inter_op_threads is per session.
+  std::int32_t intra_op_threads = 1;
+  std::int32_t inter_op_threads = 1;
+  // If set, the sessions run their ops on this process-wide pool of `inter_op_threads` threads instead.
+  std::string inter_op_pool_name;
+};
+
+// Sessions over one shared graph, each with its own thread pools, so concurrent requests scale
+// across cores without oversubscribing one big session.
+class SessionPool {
+ public:
+  // Returns the session to the pool when destroyed.
+  class Lease {
+   public:
+    Lease() = default;
+
+    Lease(Lease&& other) noexcept;
+
+    Lease& operator=(Lease&& other) noexcept;
+
+    ~Lease();
+
+    TF_Session* get() const { return session_; }
+
+    explicit operator bool() const { return session_ != nullptr; }
+
+   private:
+    friend class SessionPool;
+
+    Lease(SessionPool* pool, TF_Session* session) : pool_{pool}, session_{session} {}
+
+    SessionPool* pool_ = nullptr;
+    TF_Session* session_ = nullptr;
+  };
+
+  static std::unique_ptr<SessionPool> Create(GraphHandle graph, const SessionPoolOptions& options, TF_Status* status = nullptr);
+
+  SessionPool(const SessionPool&) = delete;
+
+  SessionPool& operator=(const SessionPool&) = delete;
+
+  // Waits up to `timeout` for a free session, an empty lease if none was returned in time.
+  Lease Checkout(std::chrono::milliseconds timeout);
+
+  // Runs on a checked out session, TF_RESOURCE_EXHAUSTED if none was free within `timeout`.
+  TF_Code Run(const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+              const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+              std::chrono::milliseconds timeout, TF_Status* status = nullptr);
+
+  TF_Graph* graph() const { return graph_.get(); }
+
+  std::size_t size() const { return sessions_.size(); }
+
+  // Sessions not checked out right now.
+  std::size_t available() const;
+
+ private:
+  explicit SessionPool(GraphHandle graph) : graph_{std::move(graph)} {}
+
+  void Return(TF_Session* session);
+
+  GraphHandle graph_;
+  std::vector<SessionHandle> sessions_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<TF_Session*> free_;
+};
+
+} // namespace tf_utils
@@ -0,0 +1,132 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "session_pool.hpp"
+#include <scope_guard.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Usage: session_pool_benchmark [graph.pb] [num_sessions] [runs]
+
+// Runs `runs` requests from `num_clients` threads, returns requests per second or -1 on error.
+static double Benchmark(tf_utils::SessionPool* pool, std::size_t num_clients, int runs) {
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(pool->graph(), "input_4"), 0}};
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(pool->graph(), "output_node0"), 0}};
+
+  std::atomic<int> next{0};
+  std::atomic<int> errors{0};
+  std::vector<std::thread> clients;
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < num_clients; ++i) {
+    clients.emplace_back([&] {
+      const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+      SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+      while (next++ < runs) {
+        std::vector<TF_Tensor*> output_tensors = {nullptr};
+        SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+        if (pool->Run(input_ops, input_tensors, out_ops, output_tensors, std::chrono::seconds{10}) != TF_OK) {
+          ++errors;
+        }
+      }
+    });
+  }
+  for (auto& c : clients) {
+    c.join();
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  if (errors != 0) {
+    return -1.0;
+  }
+  return runs / std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  // Gives every session its own intra-op pool of intra_op_threads, otherwise the first session created
+  // sizes one pool for the whole process. Must be set before the first session is created.
+  setenv("TF_OVERRIDE_GLOBAL_THREADPOOL", "1", 0);
+
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  auto num_sessions = static_cast<std::size_t>(argc > 2 ? std::atoi(argv[2]) : 4);
+  auto runs = argc > 3 ? std::atoi(argv[3]) : 200;
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto graph = tf_utils::ModelRegistry::Instance().GetGraph(graph_path, status);
+  if (graph == nullptr) {
+    std::cout << "Can't load graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  // The same thread budget either in one session or split across the pool.
+  tf_utils::SessionPoolOptions single_options;
+  single_options.num_sessions = 1;
+  single_options.intra_op_threads = static_cast<std::int32_t>(num_sessions);
+  auto single = tf_utils::SessionPool::Create(graph, single_options, status);
+
+  tf_utils::SessionPoolOptions pool_options;
+  pool_options.num_sessions = num_sessions;
+  pool_options.intra_op_threads = 1;
+  auto pool = tf_utils::SessionPool::Create(graph, pool_options, status);
+
+  if (single == nullptr || pool == nullptr) {
+    std::cout << "Can't create sessions: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  // Every session is checked out, so the next checkout has to time out.
+  {
+    std::vector<tf_utils::SessionPool::Lease> leases;
+    for (std::size_t i = 0; i < pool->size(); ++i) {
+      leases.push_back(pool->Checkout(std::chrono::milliseconds{0}));
+    }
+    if (pool->available() != 0 || pool->Checkout(std::chrono::milliseconds{10})) {
+      std::cout << "Checkout of an exhausted pool did not time out" << std::endl;
+      return 2;
+    }
+  }
+  if (pool->available() != pool->size()) {
+    std::cout << "Leases were not returned" << std::endl;
+    return 2;
+  }
+
+  auto single_rps = Benchmark(single.get(), 2 * num_sessions, runs);
+  auto pool_rps = Benchmark(pool.get(), 2 * num_sessions, runs);
+  if (single_rps < 0.0 || pool_rps < 0.0) {
+    std::cout << "Error run session" << std::endl;
+    return 1;
+  }
+
+  std::cout << "1 session x " << num_sessions << " intra-op threads: " << single_rps << " runs/s" << std::endl;
+  std::cout << num_sessions << " sessions x 1 intra-op thread: " << pool_rps << " runs/s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_registry.hpp"
+#include <scope_guard.hpp>
+#include <iostream>
+#include <vector>
+
+static TF_Code Run(TF_Session* session, TF_Graph* graph, float* result) {
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  std::vector<TF_Tensor*> output_tensors = {nullptr};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+  auto code = tf_utils::RunSession(session, input_ops, input_tensors, out_ops, output_tensors);
+  if (code == TF_OK) {
+    *result = static_cast<float*>(TF_TensorData(output_tensors[0]))[0];
+  }
+
+  return code;
+}
+
+int main() {
+  auto& registry = tf_utils::ModelRegistry::Instance();
+
+  auto graph = registry.GetGraph("graph.pb");
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session_1 = tf_utils::CreateSession(graph);
+  auto session_2 = tf_utils::CreateSession(registry.GetGraph("./graph.pb"));
+  if (session_1 == nullptr || session_2 == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 2;
+  }
+
+  if (registry.GetGraph("graph.pb") != graph || registry.size() != 1) {
+    std::cout << "Graph is not shared" << std::endl;
+    return 3;
+  }
+
+  float result_1 = 0.0f;
+  float result_2 = 0.0f;
+  if (Run(session_1.get(), graph.get(), &result_1) != TF_OK || Run(session_2.get(), graph.get(), &result_2) != TF_OK) {
+    std::cout << "Error run session" << std::endl;
+    return 4;
+  }
+
+  if (result_1 != result_2) {
+    std::cout << "Sessions disagree: " << result_1 << " vs " << result_2 << std::endl;
+    return 5;
+  }
+
+  // The graph stays alive while any session still uses it.
+  graph.reset();
+  session_1.reset();
+  if (registry.size() != 1) {
+    std::cout << "Graph released too early" << std::endl;
+    return 6;
+  }
+
+  session_2.reset();
+  if (registry.size() != 0) {
+    std::cout << "Graph is not released" << std::endl;
+    return 7;
+  }
+
+  // A pruned graph that is already loaded still reports what pruning dropped.
+  tf_utils::LoadGraphOptions options;
+  options.feeds = {"input_4"};
+  options.fetches = {"output_node0"};
+  tf_utils::PruneStats first_stats;
+  options.prune_stats = &first_stats;
+  auto pruned = registry.GetGraph("graph.pb", options);
+  tf_utils::PruneStats hit_stats;
+  options.prune_stats = &hit_stats;
+  if (pruned == nullptr || registry.GetGraph("graph.pb", options) != pruned ||
+      hit_stats.nodes_dropped != first_stats.nodes_dropped || hit_stats.bytes_dropped != first_stats.bytes_dropped) {
+    std::cout << "Prune stats are not kept for cached graphs" << std::endl;
+    return 8;
+  }
+
+  std::cout << "Shared graph success" << std::endl;
+
+  return 0;
+}
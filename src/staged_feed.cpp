@@ -0,0 +1,88 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "partial_run.hpp"
+#include <scope_guard.hpp>
+#include <iostream>
+#include <vector>
+
+// Usage: staged_feed [graph.pb]
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const TF_Output input = {TF_GraphOperationByName(graph, "input_4"), 0};
+  const TF_Output hidden = {TF_GraphOperationByName(graph, "sru_10/Sum"), 0};
+  const TF_Output output = {TF_GraphOperationByName(graph, "output_node0"), 0};
+
+  auto run = tf_utils::PartialRun::Setup(session, {input}, {hidden, output}, {}, status);
+  if (run == nullptr) {
+    std::cout << "Can't set up partial run: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+  SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+  // First stage: feed the input and fetch the hidden state as soon as it is computed.
+  std::vector<TF_Tensor*> hidden_tensors;
+  SCOPE_EXIT{ tf_utils::DeleteTensors(hidden_tensors); };
+  auto code = run->Run({input}, input_tensors, {hidden}, hidden_tensors, {}, status);
+  if (code != TF_OK) {
+    std::cout << "Error first stage TF_CODE: " << code << " " << TF_Message(status) << std::endl;
+    return code;
+  }
+  std::cout << "Hidden state: " << TF_TensorByteSize(hidden_tensors[0]) / sizeof(float) << " floats" << std::endl;
+
+  // Last stage: the rest of the same step, nothing computed so far runs again.
+  std::vector<TF_Tensor*> output_tensors;
+  SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+  code = run->Fetch({output}, output_tensors, status);
+  if (code != TF_OK) {
+    std::cout << "Error last stage TF_CODE: " << code << " " << TF_Message(status) << std::endl;
+    return code;
+  }
+
+  auto data = static_cast<float*>(TF_TensorData(output_tensors[0]));
+  std::cout << "Output vals: " << data[0] << ", " << data[1] << ", " << data[2] << ", " << data[3] << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace tf_utils {
+
+// Non-owning view of contiguous elements, like std::span.
+template <typename T>
+class Span {
+ public:
+  Span() = default;
+
+  Span(T* data, std::size_t size) : data_{data}, size_{size} {}
+
+  T* data() const { return data_; }
+
+  std::size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  T* begin() const { return data_; }
+
+  T* end() const { return data_ + size_; }
+
+  T& operator[](std::size_t i) const {
+    assert(i < size_);
+    return data_[i];
+  }
+
+  T& at(std::size_t i) const {
+    if (i >= size_) {
+      throw std::out_of_range{"tf_utils::Span index out of range"};
+    }
+    return data_[i];
+  }
+
+ private:
+  T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Owns a TF_Tensor and reads or writes its elements in place. Move-only, the tensor is deleted with it.
+template <typename T>
+class Tensor {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value, "Tensor elements must be trivially copyable");
+
+  Tensor() = default;
+
+  // Takes ownership of `tensor`, whose elements must be of type T.
+  explicit Tensor(TF_Tensor* tensor) : tensor_{tensor} {
+    // The variable-size dtypes match any T but have no elements to index.
+    assert(tensor_ == nullptr ||
+           (MatchesDataType<T>(TF_TensorType(tensor_)) && TF_DataTypeSize(TF_TensorType(tensor_)) == sizeof(T)));
+  }
+
+  Tensor(Tensor&& other) noexcept : tensor_{other.tensor_} {
+    other.tensor_ = nullptr;
+  }
+
+  Tensor& operator=(Tensor&& other) noexcept {
+    if (this != &other) {
+      reset(other.tensor_);
+      other.tensor_ = nullptr;
+    }
+    return *this;
+  }
+
+  Tensor(const Tensor&) = delete;
+
+  Tensor& operator=(const Tensor&) = delete;
+
+  ~Tensor() { reset(); }
+
+  TF_Tensor* get() const { return tensor_; }
+
+  explicit operator bool() const { return tensor_ != nullptr; }
+
+  // Gives up ownership, delete the result with TF_DeleteTensor.
+  TF_Tensor* release() {
+    auto tensor = tensor_;
+    tensor_ = nullptr;
+    return tensor;
+  }
+
+  void reset(TF_Tensor* tensor = nullptr) {
+    if (tensor_ != nullptr) {
+      TF_DeleteTensor(tensor_);
+    }
+    tensor_ = tensor;
+  }
+
+  int rank() const { return tensor_ == nullptr ? 0 : TF_NumDims(tensor_); }
+
+  std::int64_t dim(int i) const {
+    assert(i >= 0 && i < rank());
+    return TF_Dim(tensor_, i);
+  }
+
+  std::vector<std::int64_t> shape() const {
+    std::vector<std::int64_t> dims(static_cast<std::size_t>(rank()));
+    for (std::size_t i = 0; i < dims.size(); ++i) {
+      dims[i] = TF_Dim(tensor_, static_cast<int>(i));
+    }
+    return dims;
+  }
+
+  // Number of elements, bounded by the buffer's byte size.
+  std::size_t size() const {
+    return tensor_ == nullptr ? 0 : TF_TensorByteSize(tensor_) / sizeof(T);
+  }
+
+  // All the elements in row-major order, valid while the tensor is owned.
+  Span<T> data() {
+    return {static_cast<T*>(tensor_ == nullptr ? nullptr : TF_TensorData(tensor_)), size()};
+  }
+
+  Span<const T> data() const {
+    return {static_cast<const T*>(tensor_ == nullptr ? nullptr : TF_TensorData(tensor_)), size()};
+  }
+
+  // Element at a full index, one per dimension, as in mdspan.
+  template <typename... Indices>
+  T& operator()(Indices... indices) {
+    return data()[Offset(indices...)];
+  }
+
+  template <typename... Indices>
+  const T& operator()(Indices... indices) const {
+    return data()[Offset(indices...)];
+  }
+
+ private:
+  template <typename... Indices>
+  std::size_t Offset(Indices... indices) const {
+    // Leading 0 so that a scalar's empty index is still a valid array.
+    const std::int64_t index[] = {0, static_cast<std::int64_t>(indices)...};
+    assert(static_cast<int>(sizeof...(Indices)) == rank());
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < sizeof...(Indices); ++i) {
+      auto d = TF_Dim(tensor_, static_cast<int>(i));
+      assert(index[i + 1] >= 0 && index[i + 1] < d);
+      offset = offset * static_cast<std::size_t>(d) + static_cast<std::size_t>(index[i + 1]);
+    }
+    return offset;
+  }
+
+  TF_Tensor* tensor_ = nullptr;
+};
+
+// Takes the tensors of a run's output vector, leaving nullptrs behind.
+template <typename T>
+std::vector<Tensor<T>> TakeTensors(std::vector<TF_Tensor*>& tensors) {
+  std::vector<Tensor<T>> owned;
+  owned.reserve(tensors.size());
+  for (auto& t : tensors) {
+    owned.emplace_back(t);
+    t = nullptr;
+  }
+  return owned;
+}
+
+} // namespace tf_utils
@@ -0,0 +1,220 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tensor_arena.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace tf_utils {
+
+namespace {
+
+// Block sizes from kTensorAlignment to kTensorAlignment << 39.
+constexpr std::size_t kNumSizeClasses = 40;
+
+constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+std::size_t SizeClass(std::size_t len) {
+  std::size_t size_class = 0;
+  while (size_class < kNumSizeClasses && (kTensorAlignment << size_class) < len) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+std::size_t RoundUp(std::size_t size, std::size_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+void* MapSlab(std::size_t len, bool huge_pages) {
+#if defined(_WIN32)
+  static_cast<void>(huge_pages);
+  return _aligned_malloc(len, kTensorAlignment);
+#else
+  auto slab = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (slab == MAP_FAILED) {
+    return nullptr;
+  }
+#  if defined(MADV_HUGEPAGE)
+  if (huge_pages) {
+    // Only a hint, the slab stays usable with normal pages if THP is disabled.
+    madvise(slab, len, MADV_HUGEPAGE);
+  }
+#  else
+  static_cast<void>(huge_pages);
+#  endif
+  return slab;
+#endif
+}
+
+void UnmapSlab(void* slab, std::size_t len) {
+#if defined(_WIN32)
+  static_cast<void>(len);
+  _aligned_free(slab);
+#else
+  munmap(slab, len);
+#endif
+}
+
+} // namespace tf_utils::
+
+struct TensorArena::State {
+  TensorArenaOptions options;
+
+  std::mutex mutex;
+  // Intrusive lists, a free block holds the pointer to the next one.
+  std::array<void*, kNumSizeClasses> free_lists{};
+  std::vector<std::pair<void*, std::size_t>> slabs;
+  std::size_t reserved_bytes = 0;
+  // Blocks held by tensors, the state outlives the arena until they are all back.
+  std::size_t used_blocks = 0;
+  bool closed = false;
+
+  ~State() {
+    for (auto& s : slabs) {
+      UnmapSlab(s.first, s.second);
+    }
+  }
+
+  // Takes a block of `size_class`, mapping a new slab if the free list is empty. Called with the lock held.
+  void* Pop(std::size_t size_class) {
+    auto& head = free_lists[size_class];
+    if (head == nullptr && !Refill(size_class)) {
+      return nullptr;
+    }
+
+    auto block = head;
+    head = *static_cast<void**>(block);
+    ++used_blocks;
+    return block;
+  }
+
+  bool Refill(std::size_t size_class) {
+    auto block_size = kTensorAlignment << size_class;
+    auto page_size = options.huge_pages ? kHugePageSize : PageSize();
+    auto slab_len = RoundUp(std::max(options.slab_size, block_size), page_size);
+    auto slab = static_cast<char*>(MapSlab(slab_len, options.huge_pages));
+    if (slab == nullptr) {
+      return false;
+    }
+    slabs.emplace_back(slab, slab_len);
+    reserved_bytes += slab_len;
+
+    auto& head = free_lists[size_class];
+    for (auto offset = slab_len / block_size * block_size; offset > 0; offset -= block_size) {
+      auto block = slab + offset - block_size;
+      *reinterpret_cast<void**>(block) = head;
+      head = block;
+    }
+    return true;
+  }
+
+  static std::size_t PageSize() {
+#if defined(_WIN32)
+    return 4096;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  }
+
+  // TF_NewTensor deallocator, `len` is the tensor's byte size and gives back the size class.
+  static void Release(void* data, std::size_t len, void* arg) {
+    auto state = static_cast<State*>(arg);
+    bool last = false;
+    {
+      std::lock_guard<std::mutex> lock{state->mutex};
+      auto& head = state->free_lists[SizeClass(len)];
+      *static_cast<void**>(data) = head;
+      head = data;
+      last = --state->used_blocks == 0 && state->closed;
+    }
+    if (last) {
+      delete state;
+    }
+  }
+};
+
+TensorArena::TensorArena(const TensorArenaOptions& options) : state_{new State} {
+  state_->options = options;
+}
+
+TensorArena::~TensorArena() {
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->closed = true;
+    last = state_->used_blocks == 0;
+  }
+  if (last) {
+    delete state_;
+  }
+}
+
+TF_Tensor* TensorArena::CreateTensor(TF_DataType data_type,
+                                     const std::int64_t* dims, std::size_t num_dims,
+                                     const void* data, std::size_t len) {
+  auto size_class = SizeClass(len);
+  if (size_class == kNumSizeClasses) {
+    return nullptr;
+  }
+
+  void* block = nullptr;
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    block = state_->Pop(size_class);
+  }
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  if (data != nullptr) {
+    std::memcpy(block, data, len);
+  }
+
+  auto tensor = WrapTensor(data_type, dims, num_dims, block, len, State::Release, state_);
+  if (tensor == nullptr) {
+    State::Release(block, len, state_);
+  }
+  return tensor;
+}
+
+std::size_t TensorArena::slab_count() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  return state_->slabs.size();
+}
+
+std::size_t TensorArena::reserved_bytes() const {
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  return state_->reserved_bytes;
+}
+
+} // namespace tf_utils
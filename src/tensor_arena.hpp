@@ -0,0 +1,79 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tf_utils {
+
+struct TensorArenaOptions {
+  // Smallest mapping carved into blocks of one size class, a larger block gets a mapping of its own.
+  std::size_t slab_size = std::size_t{2} << 20;
+  // Ask for transparent huge pages on the slabs, on Linux with THP in madvise or always mode.
+  bool huge_pages = false;
+};
+
+// Hands out kTensorAlignment aligned blocks for input tensors from large slabs. Blocks are rounded up
+// to power-of-two size classes and return to the class's free list through the TF_NewTensor
+// deallocator, so once every class in use has a slab, creating and deleting tensors never calls
+// malloc or free. Slabs are only unmapped when the arena and all its tensors are gone.
+class TensorArena {
+ public:
+  explicit TensorArena(const TensorArenaOptions& options = TensorArenaOptions{});
+
+  ~TensorArena();
+
+  TensorArena(const TensorArena&) = delete;
+
+  TensorArena& operator=(const TensorArena&) = delete;
+
+  // Like tf_utils::CreateTensor, `len` bytes of `data` are copied in unless it is null.
+  TF_Tensor* CreateTensor(TF_DataType data_type,
+                          const std::int64_t* dims, std::size_t num_dims,
+                          const void* data, std::size_t len);
+
+  template <typename T>
+  TF_Tensor* CreateTensor(TF_DataType data_type, const std::vector<std::int64_t>& dims, const std::vector<T>& data) {
+    if (!MatchesDataType<T>(data_type)) {
+      return nullptr;
+    }
+    return CreateTensor(data_type,
+                        dims.data(), dims.size(),
+                        data.data(), data.size() * sizeof(T));
+  }
+
+  std::size_t slab_count() const;
+
+  // Bytes mapped for all slabs.
+  std::size_t reserved_bytes() const;
+
+ private:
+  struct State;
+
+  State* state_;
+};
+
+} // namespace tf_utils
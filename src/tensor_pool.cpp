@@ -0,0 +1,222 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tensor_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#else
+#  include <cstdlib>
+#endif
+
+namespace tf_utils {
+
+namespace {
+
+void* AllocateBuffer(std::size_t len) {
+  len = std::max(len, std::size_t{1});
+#if defined(_WIN32)
+  return _aligned_malloc(len, kTensorAlignment);
+#else
+  void* buffer = nullptr;
+  return posix_memalign(&buffer, kTensorAlignment, len) == 0 ? buffer : nullptr;
+#endif
+}
+
+void FreeBuffer(void* buffer) {
+#if defined(_WIN32)
+  _aligned_free(buffer);
+#else
+  std::free(buffer);
+#endif
+}
+
+} // namespace tf_utils::
+
+struct TensorPool::State {
+  std::mutex mutex;
+  // Each buffer to the tensor it was issued as, an output aliasing the buffer is another TF_Tensor.
+  std::unordered_map<void*, TF_Tensor*> issued;
+  bool closed = false;
+
+  // TF_NewTensor deallocator, the buffer is gone once TensorFlow drops its last reference.
+  static void Free(void* data, std::size_t, void* arg) {
+    auto state = static_cast<State*>(arg);
+    bool last = false;
+    {
+      std::lock_guard<std::mutex> lock{state->mutex};
+      state->issued.erase(data);
+      last = state->issued.empty() && state->closed;
+    }
+    FreeBuffer(data);
+    if (last) {
+      delete state;
+    }
+  }
+
+  bool Issued(TF_Tensor* tensor) {
+    std::lock_guard<std::mutex> lock{mutex};
+    auto it = issued.find(TF_TensorData(tensor));
+    return it != issued.end() && it->second == tensor;
+  }
+};
+
+constexpr std::size_t TensorPool::kMaxRank;
+
+bool TensorPool::Key::operator==(const Key& other) const {
+  return data_type == other.data_type &&
+         num_dims == other.num_dims &&
+         std::equal(dims, dims + num_dims, other.dims);
+}
+
+std::size_t TensorPool::KeyHash::operator()(const Key& key) const {
+  auto hash = std::hash<int>{}(key.data_type) ^ (key.num_dims << 8);
+  for (std::size_t i = 0; i < key.num_dims; ++i) {
+    hash = hash * 31 + std::hash<std::int64_t>{}(key.dims[i]);
+  }
+  return hash;
+}
+
+bool TensorPool::MakeKey(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, Key* key) {
+  if (num_dims > kMaxRank || TF_DataTypeSize(data_type) == 0) {
+    return false;
+  }
+  key->data_type = data_type;
+  key->num_dims = num_dims;
+  std::copy(dims, dims + num_dims, key->dims);
+  return true;
+}
+
+TensorPool::TensorPool(std::size_t budget_bytes) : budget_bytes_{budget_bytes}, state_{new State} {}
+
+TensorPool::~TensorPool() {
+  for (auto& i : idle_) {
+    DeleteTensors(i.second);
+  }
+
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock{state_->mutex};
+    state_->closed = true;
+    last = state_->issued.empty();
+  }
+  if (last) {
+    delete state_;
+  }
+}
+
+TF_Tensor* TensorPool::Acquire(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims) {
+  if (dims == nullptr && num_dims != 0) {
+    return nullptr;
+  }
+
+  std::size_t len = TF_DataTypeSize(data_type);
+  for (std::size_t i = 0; i < num_dims; ++i) {
+    len *= static_cast<std::size_t>(dims[i]);
+  }
+
+  Key key{};
+  if (!MakeKey(data_type, dims, num_dims, &key)) {
+    return TF_AllocateTensor(data_type, dims, static_cast<int>(num_dims), len);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto it = idle_.find(key);
+    if (it != idle_.end() && !it->second.empty()) {
+      auto tensor = it->second.back();
+      it->second.pop_back();
+      ++stats_.hits;
+      stats_.pooled_bytes -= TF_TensorByteSize(tensor);
+      return tensor;
+    }
+    ++stats_.misses;
+  }
+
+  auto buffer = AllocateBuffer(len);
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  auto tensor = WrapTensor(data_type, dims, num_dims, buffer, len, State::Free, state_);
+  if (tensor == nullptr) {
+    FreeBuffer(buffer);
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock{state_->mutex};
+  state_->issued[buffer] = tensor;
+  return tensor;
+}
+
+TF_Tensor* TensorPool::CreateTensor(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, const void* data, std::size_t len) {
+  auto tensor = Acquire(data_type, dims, num_dims);
+  if (tensor != nullptr && data != nullptr) {
+    std::memcpy(TF_TensorData(tensor), data, std::min(len, TF_TensorByteSize(tensor)));
+  }
+  return tensor;
+}
+
+void TensorPool::Release(TF_Tensor* tensor) {
+  if (tensor == nullptr) {
+    return;
+  }
+
+  // Whether an output still aliases the buffer can't be told through the C API, TF_TensorMaybeMove never
+  // succeeds in TF 1.x. Callers delete such outputs first, see Release.
+  Key key{};
+  std::int64_t dims[kMaxRank];
+  auto num_dims = static_cast<std::size_t>(TF_NumDims(tensor));
+  auto poolable = num_dims <= kMaxRank && state_->Issued(tensor);
+  for (std::size_t i = 0; poolable && i < num_dims; ++i) {
+    dims[i] = TF_Dim(tensor, static_cast<int>(i));
+  }
+  poolable = poolable && MakeKey(TF_TensorType(tensor), dims, num_dims, &key);
+
+  auto len = TF_TensorByteSize(tensor);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (poolable && stats_.pooled_bytes + len <= budget_bytes_) {
+      idle_[key].push_back(tensor);
+      stats_.pooled_bytes += len;
+      return;
+    }
+    ++stats_.dropped;
+  }
+
+  TF_DeleteTensor(tensor);
+}
+
+void TensorPool::Release(const std::vector<TF_Tensor*>& tensors) {
+  for (auto t : tensors) {
+    Release(t);
+  }
+}
+
+TensorPoolStats TensorPool::stats() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return stats_;
+}
+
+} // namespace tf_utils
@@ -0,0 +1,111 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tf_utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace tf_utils {
+
+struct TensorPoolStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  // Released tensors deleted because the pool didn't issue them or the budget was used up.
+  std::uint64_t dropped = 0;
+  std::size_t pooled_bytes = 0;
+};
+
+// Recycles idle tensors by dtype and shape, for requests that create the same inputs over and over.
+// Only fixed-size dtypes of up to kMaxRank dimensions are pooled, and only tensors the pool made itself
+// are taken back: a session output can share its buffer with a Const or another output.
+class TensorPool {
+ public:
+  static constexpr std::size_t kMaxRank = 8;
+
+  // At most `budget_bytes` of idle tensors are kept.
+  explicit TensorPool(std::size_t budget_bytes);
+
+  ~TensorPool();
+
+  TensorPool(const TensorPool&) = delete;
+
+  TensorPool& operator=(const TensorPool&) = delete;
+
+  // A tensor of this dtype and shape, recycled if one is idle. Its contents are unspecified.
+  TF_Tensor* Acquire(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims);
+
+  TF_Tensor* Acquire(TF_DataType data_type, const std::vector<std::int64_t>& dims) {
+    return Acquire(data_type, dims.data(), dims.size());
+  }
+
+  // Acquire with `len` bytes of `data` copied in, a drop-in for tf_utils::CreateTensor.
+  TF_Tensor* CreateTensor(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, const void* data, std::size_t len);
+
+  template <typename T>
+  TF_Tensor* CreateTensor(TF_DataType data_type, const std::vector<std::int64_t>& dims, const std::vector<T>& data) {
+    if (!MatchesDataType<T>(data_type)) {
+      return nullptr;
+    }
+    return CreateTensor(data_type, dims.data(), dims.size(), data.data(), data.size() * sizeof(T));
+  }
+
+  // Takes a tensor back instead of DeleteTensor, it is kept if the pool issued it and it fits in the budget,
+  // anything else is deleted. An output can alias an input (Identity, Reshape, ...), so release the inputs of
+  // a run only after deleting its outputs.
+  void Release(TF_Tensor* tensor);
+
+  void Release(const std::vector<TF_Tensor*>& tensors);
+
+  TensorPoolStats stats() const;
+
+ private:
+  struct Key {
+    TF_DataType data_type;
+    std::size_t num_dims;
+    std::int64_t dims[kMaxRank];
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  static bool MakeKey(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims, Key* key);
+
+  struct State;
+
+  const std::size_t budget_bytes_;
+  // Buffers of the issued tensors, it outlives the pool until they are all freed.
+  State* state_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, std::vector<TF_Tensor*>, KeyHash> idle_;
+  TensorPoolStats stats_;
+};
+
+} // namespace tf_utils
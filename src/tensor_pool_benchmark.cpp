@@ -0,0 +1,110 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tensor_pool.hpp"
+#include <scope_guard.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Usage: tensor_pool_benchmark [graph.pb] [iterations]
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  const int iterations = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+  auto graph = tf_utils::LoadGraph(graph_path);
+  SCOPE_EXIT{ tf_utils::DeleteGraph(graph); };
+  if (graph == nullptr) {
+    std::cout << "Can't load graph" << std::endl;
+    return 1;
+  }
+
+  auto session = tf_utils::CreateSession(graph);
+  SCOPE_EXIT{ tf_utils::DeleteSession(session); };
+  if (session == nullptr) {
+    std::cout << "Can't create session" << std::endl;
+    return 1;
+  }
+
+  const std::vector<TF_Output> inputs = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Output> outputs = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+
+  tf_utils::TensorPool pool{std::size_t{1} << 20};
+
+  // Same request loop, the input either created and deleted or taken from and given back to the pool.
+  for (auto pooled : {false, true}) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      const std::vector<TF_Tensor*> input_tensors = {pooled ? pool.CreateTensor(TF_FLOAT, input_dims, input_vals)
+                                                            : tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+      std::vector<TF_Tensor*> output_tensors = {nullptr};
+      auto code = tf_utils::RunSession(session, inputs, input_tensors, outputs, output_tensors);
+      // The outputs go first, one of them may alias the input.
+      tf_utils::DeleteTensors(output_tensors);
+      if (pooled) {
+        pool.Release(input_tensors);
+      } else {
+        tf_utils::DeleteTensors(input_tensors);
+      }
+      if (code != TF_OK) {
+        std::cout << "Error run session TF_CODE: " << code << std::endl;
+        return code;
+      }
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    std::cout << (pooled ? "TensorPool: " : "CreateTensor: ")
+              << std::chrono::duration<double, std::micro>(stop - start).count() / iterations << " us per request" << std::endl;
+  }
+
+  auto stats = pool.stats();
+  std::cout << "Hits: " << stats.hits << ", misses: " << stats.misses << ", dropped: " << stats.dropped
+            << ", pooled: " << stats.pooled_bytes << " bytes" << std::endl;
+
+  // Only the first request allocates, every later one gets the input of the request before it.
+  if (stats.hits + 1 < static_cast<std::uint64_t>(iterations) || stats.dropped != 0) {
+    std::cout << "Inputs are not recycled" << std::endl;
+    return 2;
+  }
+
+  // Nothing is kept over the budget.
+  tf_utils::TensorPool no_budget{0};
+  no_budget.Release(no_budget.Acquire(TF_FLOAT, input_dims));
+  if (no_budget.stats().dropped != 1 || no_budget.stats().pooled_bytes != 0) {
+    std::cout << "Budget is not enforced" << std::endl;
+    return 3;
+  }
+
+  // A tensor the pool didn't make, like a session output, is deleted rather than handed out again.
+  tf_utils::TensorPool foreign{std::size_t{1} << 20};
+  foreign.Release(tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals));
+  if (foreign.stats().dropped != 1 || foreign.stats().pooled_bytes != 0) {
+    std::cout << "Foreign tensor is pooled" << std::endl;
+    return 4;
+  }
+
+  return 0;
+}
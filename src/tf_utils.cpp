@@ -21,29 +21,34 @@
 // SOFTWARE.
 
 #include "tf_utils.hpp"
+#include "session_options.hpp"
+#include "wire_format.hpp"
 #include <scope_guard.hpp>
 #include <algorithm>
-#include <array>
+#include <climits>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
-
-// #ifdef __cplusplus
-// extern "C" {
-// #endif
-
-// int64_t TF_TensorElementCount(const TF_Tensor* t) {
-//   int64_t result = 1;
-//   int rank = TF_NumDims(t);
-//   for (int dim = 0; dim < rank; ++dim) {
-//     result *= TF_Dim(t, dim);
-//   }
-//   return result;
-// }
-
-// #ifdef __cplusplus
-// } /* end extern "C" */
-// #endif
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#if defined(TF_UTILS_WITH_ZLIB)
+#  include <zlib.h>
+#endif
+#if defined(TF_UTILS_WITH_ZSTD)
+#  include <zstd.h>
+#endif
+
+#if defined(_WIN32)
+#  include <direct.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
 
 namespace tf_utils {
 
@@ -79,6 +84,421 @@ static TF_Buffer* ReadBufferFromFile(const char* file) {
   return buf;
 }
 
+#if !defined(_WIN32)
+static void UnmapBuffer(void* data, size_t length) {
+  munmap(data, length);
+}
+#endif
+
+static TF_Buffer* MapBufferFromFile(const char* file) {
+#if defined(_WIN32)
+  return ReadBufferFromFile(file);
+#else
+  auto fd = open(file, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+  SCOPE_EXIT{ close(fd); };
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < 1) {
+    return nullptr;
+  }
+
+  auto fsize = static_cast<std::size_t>(st.st_size);
+  auto data = mmap(nullptr, fsize, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // The importer parses the GraphDef front to back exactly once.
+  madvise(data, fsize, MADV_SEQUENTIAL);
+  madvise(data, fsize, MADV_WILLNEED);
+
+  auto buf = TF_NewBuffer();
+  buf->data = data;
+  buf->length = fsize;
+  buf->data_deallocator = UnmapBuffer;
+
+  return buf;
+#endif
+}
+
+enum class Compression { kNone, kGzip, kZstd };
+
+static Compression DetectCompression(const char* file) {
+  std::ifstream f(file, std::ios::binary);
+  unsigned char magic[4] = {};
+  f.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  auto n = f.gcount();
+
+  if (n >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+    return Compression::kGzip;
+  }
+  if (n == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+    return Compression::kZstd;
+  }
+  return Compression::kNone;
+}
+
+// Compressed input is read in chunks of this size, the output is decompressed straight into the TF_Buffer data.
+constexpr std::size_t kReadChunkSize = 256 * 1024;
+
+struct DecompressBuffer {
+  char* data = nullptr;
+  std::size_t size = 0;
+  std::size_t capacity = 0;
+
+  ~DecompressBuffer() { std::free(data); }
+
+  // Makes room for at least `n` more bytes, doubling the allocation when it has to grow.
+  bool Reserve(std::size_t n) {
+    if (capacity - size >= n) {
+      return true;
+    }
+    auto new_capacity = std::max(capacity * 2, size + n);
+    auto new_data = static_cast<char*>(std::realloc(data, new_capacity));
+    if (new_data == nullptr) {
+      return false;
+    }
+    data = new_data;
+    capacity = new_capacity;
+    return true;
+  }
+
+  TF_Buffer* Release() {
+    auto buf = TF_NewBuffer();
+    buf->data = data;
+    buf->length = size;
+    buf->data_deallocator = DeallocateBuffer;
+    data = nullptr;
+    return buf;
+  }
+};
+
+static TF_Buffer* InflateBufferFromFile(const char* file) {
+#if defined(TF_UTILS_WITH_ZLIB)
+  std::ifstream f(file, std::ios::binary);
+  if (!f.is_open()) {
+    return nullptr;
+  }
+
+  // The gzip trailer holds the uncompressed size modulo 2^32, right for any single member GraphDef.
+  unsigned char isize[4] = {};
+  f.seekg(-4, std::ios::end);
+  f.read(reinterpret_cast<char*>(isize), sizeof(isize));
+  f.clear();
+  f.seekg(0, std::ios::beg);
+  auto size_hint = static_cast<std::size_t>(isize[0]) | static_cast<std::size_t>(isize[1]) << 8 |
+                   static_cast<std::size_t>(isize[2]) << 16 | static_cast<std::size_t>(isize[3]) << 24;
+
+  DecompressBuffer out;
+  if (!out.Reserve(std::max<std::size_t>(size_hint, 1))) {
+    return nullptr;
+  }
+
+  z_stream stream{};
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) { // 16 - gzip header and trailer.
+    return nullptr;
+  }
+  SCOPE_EXIT{ inflateEnd(&stream); };
+
+  std::vector<char> chunk(kReadChunkSize);
+  auto need_input = true;
+  for (;;) {
+    if (stream.avail_in == 0 && need_input) {
+      f.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      stream.next_in = reinterpret_cast<Bytef*>(chunk.data());
+      stream.avail_in = static_cast<uInt>(f.gcount());
+      if (stream.avail_in == 0) {
+        return nullptr; // Truncated stream.
+      }
+    }
+    if (!out.Reserve(1)) {
+      return nullptr;
+    }
+
+    auto avail_out = std::min<std::size_t>(out.capacity - out.size, UINT_MAX);
+    stream.next_out = reinterpret_cast<Bytef*>(out.data + out.size);
+    stream.avail_out = static_cast<uInt>(avail_out);
+    auto ret = inflate(&stream, Z_NO_FLUSH);
+    out.size += avail_out - stream.avail_out;
+
+    if (ret == Z_STREAM_END) {
+      return out.Release();
+    }
+    if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      return nullptr;
+    }
+    // A full output buffer may still hold back decompressed data, drain it before reading more.
+    need_input = ret == Z_BUF_ERROR || stream.avail_out != 0;
+  }
+#else
+  static_cast<void>(file);
+  return nullptr;
+#endif
+}
+
+static TF_Buffer* DecompressZstdBufferFromFile(const char* file) {
+#if defined(TF_UTILS_WITH_ZSTD)
+  std::ifstream f(file, std::ios::binary);
+  if (!f.is_open()) {
+    return nullptr;
+  }
+
+  auto stream = ZSTD_createDStream();
+  if (stream == nullptr) {
+    return nullptr;
+  }
+  SCOPE_EXIT{ ZSTD_freeDStream(stream); };
+  if (ZSTD_isError(ZSTD_initDStream(stream))) {
+    return nullptr;
+  }
+
+  std::vector<char> chunk(kReadChunkSize);
+  f.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+  ZSTD_inBuffer in = {chunk.data(), static_cast<std::size_t>(f.gcount()), 0};
+
+  // The frame header usually records the content size, otherwise grow from a few chunks.
+  auto size_hint = ZSTD_getFrameContentSize(in.src, in.size);
+  DecompressBuffer out;
+  if (!out.Reserve(size_hint == ZSTD_CONTENTSIZE_UNKNOWN || size_hint == ZSTD_CONTENTSIZE_ERROR || size_hint == 0
+                       ? 4 * kReadChunkSize
+                       : static_cast<std::size_t>(size_hint))) {
+    return nullptr;
+  }
+
+  auto need_input = false;
+  for (;;) {
+    if (in.pos == in.size && need_input) {
+      f.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      in = {chunk.data(), static_cast<std::size_t>(f.gcount()), 0};
+      if (in.size == 0) {
+        return nullptr; // Truncated stream.
+      }
+    }
+    if (!out.Reserve(1)) {
+      return nullptr;
+    }
+
+    ZSTD_outBuffer output = {out.data + out.size, out.capacity - out.size, 0};
+    auto ret = ZSTD_decompressStream(stream, &output, &in);
+    out.size += output.pos;
+
+    if (ZSTD_isError(ret)) {
+      return nullptr;
+    }
+    if (ret == 0) {
+      return out.Release();
+    }
+    // A full output buffer may still hold back decompressed data, drain it before reading more.
+    need_input = output.pos < output.size;
+  }
+#else
+  static_cast<void>(file);
+  return nullptr;
+#endif
+}
+
+// Field numbers of the TensorFlow protos rewritten below, see tensorflow/core/framework/*.proto.
+enum : std::uint32_t {
+  kGraphDefNode = 1,
+
+  kNodeDefName = 1,
+  kNodeDefOp = 2,
+  kNodeDefInput = 3,
+  kNodeDefDevice = 4,
+  kNodeDefAttr = 5,
+
+  kAttrEntryKey = 1,
+  kAttrEntryValue = 2,
+
+  kAttrValueS = 2,
+  kAttrValueType = 6,
+  kAttrValueShape = 7,
+  kAttrValueTensor = 8,
+
+  kTensorProtoDtype = 1,
+  kTensorProtoShape = 2,
+  kTensorProtoContent = 4,
+
+  kTensorShapeDim = 2,
+  kTensorShapeDimSize = 1,
+};
+
+struct NodeDef {
+  std::string name;
+  std::string op;
+  std::vector<std::string> inputs;
+  std::string device;
+  std::vector<std::pair<std::string, std::string>> attrs; // Attr name and serialized AttrValue.
+  std::string unknown_fields;
+};
+
+static bool ParseNodeDef(const char* data, std::size_t size, NodeDef* node) {
+  wire::Reader reader{data, size};
+  while (reader.Next()) {
+    switch (reader.field()) {
+      case kNodeDefName:
+        node->name = reader.str();
+        break;
+      case kNodeDefOp:
+        node->op = reader.str();
+        break;
+      case kNodeDefInput:
+        node->inputs.push_back(reader.str());
+        break;
+      case kNodeDefDevice:
+        node->device = reader.str();
+        break;
+      case kNodeDefAttr: {
+        std::pair<std::string, std::string> attr;
+        wire::Reader entry{reader.data(), reader.size()};
+        while (entry.Next()) {
+          if (entry.field() == kAttrEntryKey) {
+            attr.first = entry.str();
+          } else if (entry.field() == kAttrEntryValue) {
+            attr.second = entry.str();
+          }
+        }
+        if (!entry.ok()) {
+          return false;
+        }
+        node->attrs.push_back(std::move(attr));
+        break;
+      }
+      default:
+        node->unknown_fields.append(reader.raw_data(), reader.raw_size());
+        break;
+    }
+  }
+
+  return reader.ok();
+}
+
+static std::string SerializeNodeDef(const NodeDef& node) {
+  wire::Writer writer;
+  writer.Bytes(kNodeDefName, node.name);
+  writer.Bytes(kNodeDefOp, node.op);
+  for (auto& i : node.inputs) {
+    writer.Bytes(kNodeDefInput, i);
+  }
+  if (!node.device.empty()) {
+    writer.Bytes(kNodeDefDevice, node.device);
+  }
+  for (auto& a : node.attrs) {
+    wire::Writer entry;
+    entry.Bytes(kAttrEntryKey, a.first);
+    entry.Bytes(kAttrEntryValue, a.second);
+    writer.Bytes(kNodeDefAttr, entry.str());
+  }
+  writer.Raw(node.unknown_fields.data(), node.unknown_fields.size());
+
+  return std::move(writer.str());
+}
+
+static const std::string* FindAttr(const NodeDef& node, const char* name) {
+  for (auto& a : node.attrs) {
+    if (a.first == name) {
+      return &a.second;
+    }
+  }
+  return nullptr;
+}
+
+static void SetAttr(NodeDef* node, const char* name, std::string value) {
+  for (auto& a : node->attrs) {
+    if (a.first == name) {
+      a.second = std::move(value);
+      return;
+    }
+  }
+  node->attrs.emplace_back(name, std::move(value));
+}
+
+static void RemoveAttr(NodeDef* node, const char* name) {
+  node->attrs.erase(std::remove_if(node->attrs.begin(), node->attrs.end(),
+                                   [name](const std::pair<std::string, std::string>& a) { return a.first == name; }),
+                    node->attrs.end());
+}
+
+static std::string AttrValueString(const std::string& s) {
+  wire::Writer writer;
+  writer.Bytes(kAttrValueS, s);
+  return std::move(writer.str());
+}
+
+struct TensorProtoView {
+  TF_DataType dtype = static_cast<TF_DataType>(0);
+  std::string shape; // Serialized TensorShapeProto.
+  const char* content = nullptr;
+  std::size_t content_size = 0;
+};
+
+// Parses the `tensor` of a serialized AttrValue.
+static bool ParseTensorAttr(const std::string& attr_value, TensorProtoView* tensor) {
+  wire::Reader attr{attr_value};
+  while (attr.Next()) {
+    if (attr.field() != kAttrValueTensor) {
+      continue;
+    }
+    wire::Reader proto{attr.data(), attr.size()};
+    while (proto.Next()) {
+      switch (proto.field()) {
+        case kTensorProtoDtype:
+          tensor->dtype = static_cast<TF_DataType>(proto.value());
+          break;
+        case kTensorProtoShape:
+          tensor->shape = proto.str();
+          break;
+        case kTensorProtoContent:
+          tensor->content = proto.data();
+          tensor->content_size = proto.size();
+          break;
+        default:
+          break;
+      }
+    }
+    return proto.ok();
+  }
+
+  return false;
+}
+
+static std::string JoinPath(const std::string& dir, const std::string& name) {
+  if (dir.empty() || dir.back() == '/' || dir.back() == '\\') {
+    return dir + name;
+  }
+  return dir + "/" + name;
+}
+
+static std::string AbsolutePath(const char* path) {
+#if defined(_WIN32)
+  char buf[_MAX_PATH];
+  return _fullpath(buf, path, _MAX_PATH) != nullptr ? std::string{buf} : std::string{path};
+#else
+  char buf[PATH_MAX];
+  return realpath(path, buf) != nullptr ? std::string{buf} : std::string{path};
+#endif
+}
+
+static void MakeDirectory(const char* path) {
+#if defined(_WIN32)
+  _mkdir(path);
+#else
+  mkdir(path, 0755);
+#endif
+}
+
+static bool WriteFile(const std::string& path, const void* data, std::size_t size) {
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  if (!f.is_open()) {
+    return false;
+  }
+  f.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  return f.good();
+}
+
 TF_Tensor* ScalarStringTensor(const char* str, TF_Status* status) {
   auto str_len = std::strlen(str);
   auto nbytes = 8 + TF_StringEncodedSize(str_len); // 8 extra bytes - for start_offset.
@@ -89,18 +509,204 @@ TF_Tensor* ScalarStringTensor(const char* str, TF_Status* status) {
   return tensor;
 }
 
+// DT_*_REF values are the base type offset by 100.
+static bool IsRefType(TF_DataType data_type) {
+  return static_cast<int>(data_type) > 100;
+}
+
+// Strips the "^" control prefix and ":<index>" output suffix of a NodeDef input.
+static std::string InputNodeName(const std::string& input) {
+  std::size_t begin = !input.empty() && input[0] == '^' ? 1 : 0;
+  auto end = input.find(':', begin);
+  return input.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+// Serializes `tensor` as the AttrValue of a Const `value`.
+static std::string TensorAttrValue(const TF_Tensor* tensor) {
+  wire::Writer shape;
+  for (int i = 0; i < TF_NumDims(tensor); ++i) {
+    wire::Writer dim;
+    dim.Int64(kTensorShapeDimSize, TF_Dim(tensor, i));
+    shape.Bytes(kTensorShapeDim, dim.str());
+  }
+
+  wire::Writer proto;
+  proto.Varint(kTensorProtoDtype, static_cast<std::uint64_t>(TF_TensorType(tensor)));
+  proto.Bytes(kTensorProtoShape, shape.str());
+  proto.Bytes(kTensorProtoContent, TF_TensorData(tensor), TF_TensorByteSize(tensor));
+
+  wire::Writer attr;
+  attr.Bytes(kAttrValueTensor, proto.str());
+  return std::move(attr.str());
+}
+
+// Rewrites every variable of `graph` into a Const holding its value in `session` and drops the
+// nodes that assign to variables (restore, initializers, ...) with everything depending on them.
+static TF_Graph* FreezeVariables(TF_Graph* graph, TF_Session* session, TF_Status* status) {
+  std::vector<TF_Output> variables;
+  std::unordered_set<std::string> dropped;
+  std::size_t pos = 0;
+  TF_Operation* oper = nullptr;
+  while ((oper = TF_GraphNextOperation(graph, &pos)) != nullptr) {
+    const std::string op_type = TF_OperationOpType(oper);
+    if (op_type == "VarHandleOp") {
+      TF_SetStatus(status, TF_UNIMPLEMENTED, "Can't freeze resource variables");
+      return nullptr;
+    }
+    if (op_type == "VariableV2" || op_type == "Variable") {
+      variables.push_back({oper, 0});
+    }
+    for (int i = 0; i < TF_OperationNumInputs(oper); ++i) {
+      if (IsRefType(TF_OperationInputType({oper, i}))) {
+        dropped.insert(TF_OperationName(oper));
+        break;
+      }
+    }
+  }
+
+  std::vector<TF_Tensor*> values(variables.size(), nullptr);
+  SCOPE_EXIT{ DeleteTensors(values); };
+  if (!variables.empty() && RunSession(session, {}, {}, variables, values, status) != TF_OK) {
+    return nullptr;
+  }
+
+  std::unordered_map<std::string, const TF_Tensor*> variable_values;
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    if (TF_TensorType(values[i]) == TF_STRING) {
+      TF_SetStatus(status, TF_UNIMPLEMENTED, "Can't freeze string variables");
+      return nullptr;
+    }
+    variable_values.emplace(TF_OperationName(variables[i].oper), values[i]);
+  }
+
+  auto buffer = TF_NewBuffer();
+  SCOPE_EXIT{ TF_DeleteBuffer(buffer); };
+  TF_GraphToGraphDef(graph, buffer, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return nullptr;
+  }
+
+  std::vector<NodeDef> nodes;
+  wire::Writer graph_def;
+  wire::Reader reader{buffer->data, buffer->length};
+  while (reader.Next()) {
+    if (reader.field() != kGraphDefNode) {
+      graph_def.Raw(reader.raw_data(), reader.raw_size());
+      continue;
+    }
+    nodes.emplace_back();
+    if (!ParseNodeDef(reader.data(), reader.size(), &nodes.back())) {
+      TF_SetStatus(status, TF_DATA_LOSS, "Malformed GraphDef");
+      return nullptr;
+    }
+  }
+
+  // Nodes are not guaranteed to be in topological order, so propagate until nothing changes.
+  for (auto changed = true; changed;) {
+    changed = false;
+    for (auto& n : nodes) {
+      if (dropped.count(n.name) != 0) {
+        continue;
+      }
+      for (auto& i : n.inputs) {
+        if (dropped.count(InputNodeName(i)) != 0) {
+          dropped.insert(n.name);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  for (auto& n : nodes) {
+    if (dropped.count(n.name) != 0) {
+      continue;
+    }
+    auto value = variable_values.find(n.name);
+    if (value != variable_values.end()) {
+      // VariableV2 and Const share the `dtype` attr.
+      n.op = "Const";
+      RemoveAttr(&n, "shape");
+      RemoveAttr(&n, "container");
+      RemoveAttr(&n, "shared_name");
+      SetAttr(&n, "value", TensorAttrValue(value->second));
+    }
+    graph_def.Bytes(kGraphDefNode, SerializeNodeDef(n));
+  }
+  nodes.clear();
+
+  auto graph_def_buffer = TF_NewBufferFromString(graph_def.str().data(), graph_def.str().size());
+  SCOPE_EXIT{ TF_DeleteBuffer(graph_def_buffer); };
+  graph_def.str().clear();
+
+  return ImportGraphDef(graph_def_buffer, status);
+}
+
+// Turns a fed node into a Placeholder of `data_type`, so nothing above it has to be imported.
+static void MakePlaceholder(NodeDef* node, TF_DataType data_type) {
+  wire::Writer dtype;
+  dtype.Int64(kAttrValueType, IsRefType(data_type) ? static_cast<int>(data_type) - 100 : data_type);
+  node->op = "Placeholder";
+  node->inputs.clear();
+  node->attrs.clear();
+  node->attrs.emplace_back("dtype", std::move(dtype.str()));
+}
+
+TF_Code RunSessionWithOptions(TF_Session* session, const TF_Buffer* run_options,
+                              const TF_Output* inputs, TF_Tensor* const* input_tensors, std::size_t ninputs,
+                              const TF_Output* outputs, TF_Tensor** output_tensors, std::size_t noutputs,
+                              TF_Status* status) {
+  // No inputs (a graph of variables or constants) or no outputs may come with null arrays, e.g. empty vectors.
+  if (session == nullptr ||
+      (ninputs > 0 && (inputs == nullptr || input_tensors == nullptr)) ||
+      (noutputs > 0 && (outputs == nullptr || output_tensors == nullptr))) {
+    if (status != nullptr) {
+      TF_SetStatus(status, TF_INVALID_ARGUMENT, "Null session, inputs or outputs");
+    }
+    return TF_INVALID_ARGUMENT;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  TF_SessionRun(session,
+                run_options, // Run options.
+                inputs, input_tensors, static_cast<int>(ninputs), // Input tensors, input tensor values, number of inputs.
+                outputs, output_tensors, static_cast<int>(noutputs), // Output tensors, output tensor values, number of outputs.
+                nullptr, 0, // Target operations, number of targets.
+                nullptr, // Run metadata.
+                status // Output status.
+  );
+
+  return TF_GetCode(status);
+}
+
 } // namespace tf_utils::
 
-TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, TF_Status* status) {
+TF_Buffer* ReadGraphDef(const char* graph_path, const LoadGraphOptions& options) {
   if (graph_path == nullptr) {
     return nullptr;
   }
 
-  auto buffer = ReadBufferFromFile(graph_path);
-  if (buffer == nullptr) {
-    return nullptr;
+  switch (DetectCompression(graph_path)) {
+    case Compression::kGzip:
+      return InflateBufferFromFile(graph_path);
+    case Compression::kZstd:
+      return DecompressZstdBufferFromFile(graph_path);
+    case Compression::kNone:
+      break;
   }
 
+  return options.memory_map ? MapBufferFromFile(graph_path) : ReadBufferFromFile(graph_path);
+}
+
+TF_Graph* ImportGraphDef(const TF_Buffer* graph_def, TF_Status* status) {
+  if (graph_def == nullptr) {
+    return nullptr;
+  }
   MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
   if (status == nullptr) {
     status = TF_NewStatus();
@@ -111,34 +717,225 @@ TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, TF_St
   auto graph = TF_NewGraph();
   auto opts = TF_NewImportGraphDefOptions();
 
-  TF_GraphImportGraphDef(graph, buffer, opts, status);
+  TF_GraphImportGraphDef(graph, graph_def, opts, status);
   TF_DeleteImportGraphDefOptions(opts);
-  TF_DeleteBuffer(buffer);
 
   if (TF_GetCode(status) != TF_OK) {
     TF_DeleteGraph(graph);
     return nullptr;
   }
 
+  return graph;
+}
+
+TF_Buffer* PruneGraphDef(const TF_Buffer* graph_def,
+                         const std::vector<std::string>& feeds, const std::vector<std::string>& fetches,
+                         PruneStats* stats, TF_Status* status) {
+  if (graph_def == nullptr) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  struct Node {
+    NodeDef def;
+    const char* raw_data;
+    std::size_t raw_size;
+  };
+
+  std::vector<Node> nodes;
+  std::unordered_map<std::string, std::size_t> node_index;
+  wire::Writer pruned;
+  wire::Reader reader{graph_def->data, graph_def->length};
+  while (reader.Next()) {
+    if (reader.field() != kGraphDefNode) {
+      pruned.Raw(reader.raw_data(), reader.raw_size());
+      continue;
+    }
+    nodes.push_back({NodeDef{}, reader.raw_data(), reader.raw_size()});
+    if (!ParseNodeDef(reader.data(), reader.size(), &nodes.back().def)) {
+      TF_SetStatus(status, TF_DATA_LOSS, "Malformed GraphDef");
+      return nullptr;
+    }
+    node_index.emplace(nodes.back().def.name, nodes.size() - 1);
+  }
+
+  if (!reader.ok()) {
+    TF_SetStatus(status, TF_DATA_LOSS, "Malformed GraphDef");
+    return nullptr;
+  }
+
+  // Only a fed first output can cut the graph, a Placeholder has no other outputs. Ops with more
+  // outputs (Split, Unpack, ...) stay whole below, their other outputs may still be read.
+  std::unordered_set<std::string> fed;
+  for (auto& f : feeds) {
+    auto colon = f.rfind(':');
+    if (colon == std::string::npos || f.compare(colon + 1, std::string::npos, "0") == 0) {
+      fed.insert(InputNodeName(f));
+    }
+  }
+
+  std::vector<std::size_t> stack;
+  for (auto& f : fetches) {
+    auto it = node_index.find(InputNodeName(f));
+    if (it == node_index.end()) {
+      TF_SetStatus(status, TF_NOT_FOUND, ("Fetch " + f + " is not in the graph").c_str());
+      return nullptr;
+    }
+    stack.push_back(it->second);
+  }
+
+  // The output type of a fed node comes from the whole graph, imported only if an op other than a Placeholder is fed.
+  TF_Graph* typed_graph = nullptr;
+  SCOPE_EXIT{ DeleteGraph(typed_graph); };
+
+  std::vector<bool> keep(nodes.size(), false);
+  std::vector<bool> rewritten(nodes.size(), false);
+  while (!stack.empty()) {
+    auto i = stack.back();
+    stack.pop_back();
+    if (keep[i]) {
+      continue;
+    }
+    keep[i] = true;
+
+    auto& node = nodes[i].def;
+    if (fed.count(node.name) != 0) {
+      if (node.op == "Placeholder") {
+        node.inputs.clear(); // Control inputs only.
+        rewritten[i] = true;
+        continue;
+      }
+      if (typed_graph == nullptr && (typed_graph = ImportGraphDef(graph_def, status)) == nullptr) {
+        return nullptr;
+      }
+      auto oper = TF_GraphOperationByName(typed_graph, node.name.c_str());
+      if (oper != nullptr && TF_OperationNumOutputs(oper) == 1) {
+        MakePlaceholder(&node, TF_OperationOutputType({oper, 0}));
+        rewritten[i] = true;
+        continue;
+      }
+    }
+    for (auto& input : node.inputs) {
+      auto it = node_index.find(InputNodeName(input));
+      if (it != node_index.end() && !keep[it->second]) {
+        stack.push_back(it->second);
+      }
+    }
+  }
+
+  std::size_t nodes_dropped = 0;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (!keep[i]) {
+      ++nodes_dropped;
+    } else if (rewritten[i]) {
+      pruned.Bytes(kGraphDefNode, SerializeNodeDef(nodes[i].def));
+    } else {
+      pruned.Raw(nodes[i].raw_data, nodes[i].raw_size);
+    }
+  }
+
+  if (stats != nullptr) {
+    stats->nodes_dropped = nodes_dropped;
+    stats->bytes_dropped = graph_def->length > pruned.str().size() ? graph_def->length - pruned.str().size() : 0;
+  }
+
+  TF_SetStatus(status, TF_OK, "");
+  return TF_NewBufferFromString(pruned.str().data(), pruned.str().size());
+}
+
+TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, const LoadGraphOptions& options, TF_Status* status) {
+  if (graph_path == nullptr) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto buffer = ReadGraphDef(graph_path, options);
+  if (buffer == nullptr) {
+    TF_SetStatus(status, TF_NOT_FOUND, "Can't read GraphDef file");
+    return nullptr;
+  }
+
+  if (!options.fetches.empty()) {
+    auto fetches = options.fetches;
+    if (checkpoint_prefix != nullptr) {
+      // The variables are only initialized by the restore ops.
+      fetches.push_back("save/restore_all");
+    }
+    auto pruned = PruneGraphDef(buffer, options.feeds, fetches, options.prune_stats, status);
+    TF_DeleteBuffer(buffer);
+    if (pruned == nullptr) {
+      return nullptr;
+    }
+    buffer = pruned;
+  }
+
+  auto graph = ImportGraphDef(buffer, status);
+  TF_DeleteBuffer(buffer);
+
+  if (graph == nullptr) {
+    return nullptr;
+  }
+
   if (checkpoint_prefix == nullptr) {
     return graph;
   }
 
-  auto checkpoint_tensor = ScalarStringTensor(checkpoint_prefix, status);
-  SCOPE_EXIT{ DeleteTensor(checkpoint_tensor); };
-  if (TF_GetCode(status) != TF_OK) {
+  auto session = CreateSession(graph, status);
+  SCOPE_EXIT{ DeleteSession(session); };
+  if (session == nullptr || RestoreCheckpoint(session, graph, checkpoint_prefix, status) != TF_OK) {
     TF_DeleteGraph(graph);
     return nullptr;
   }
 
+  if (options.freeze_variables) {
+    auto frozen_graph = FreezeVariables(graph, session, status);
+    TF_DeleteGraph(graph);
+    return frozen_graph;
+  }
+
+  return graph;
+}
+
+TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, TF_Status* status) {
+  return LoadGraph(graph_path, checkpoint_prefix, LoadGraphOptions{}, status);
+}
+
+TF_Graph* LoadGraph(const char* graph_path, TF_Status* status) {
+  return LoadGraph(graph_path, nullptr, status);
+}
+
+TF_Code RestoreCheckpoint(TF_Session* session, TF_Graph* graph, const char* checkpoint_prefix, TF_Status* status) {
+  if (session == nullptr || graph == nullptr || checkpoint_prefix == nullptr) {
+    return TF_INVALID_ARGUMENT;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
   auto input = TF_Output{TF_GraphOperationByName(graph, "save/Const"), 0};
   auto restore_op = TF_GraphOperationByName(graph, "save/restore_all");
+  if (input.oper == nullptr || restore_op == nullptr) {
+    TF_SetStatus(status, TF_NOT_FOUND, "Graph has no save/Const or save/restore_all operation");
+    return TF_GetCode(status);
+  }
 
-  auto session = CreateSession(graph);
-  SCOPE_EXIT{ DeleteSession(session); };
-  if (session == nullptr) {
-    TF_DeleteGraph(graph);
-    return nullptr;
+  auto checkpoint_tensor = ScalarStringTensor(checkpoint_prefix, status);
+  SCOPE_EXIT{ DeleteTensor(checkpoint_tensor); };
+  if (TF_GetCode(status) != TF_OK) {
+    return TF_GetCode(status);
   }
 
   TF_SessionRun(session,
@@ -149,16 +946,165 @@ TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, TF_St
                 nullptr, // Run metadata.
                 status // Output status.
   );
-  if (TF_GetCode(status) != TF_OK) {
-    TF_DeleteGraph(graph);
+
+  return TF_GetCode(status);
+}
+
+TF_Session* LoadSession(const char* graph_path, const char* checkpoint_prefix, TF_Graph** graph, TF_Status* status) {
+  if (graph == nullptr) {
+    return nullptr;
+  }
+  *graph = nullptr;
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto loaded_graph = LoadGraph(graph_path, nullptr, LoadGraphOptions{}, status);
+  if (loaded_graph == nullptr) {
     return nullptr;
   }
 
-  return graph;
+  auto session = CreateSession(loaded_graph, status);
+  if (session == nullptr) {
+    TF_DeleteGraph(loaded_graph);
+    return nullptr;
+  }
+
+  // Variables live in the session, so restoring into this one leaves it ready for inference.
+  if (checkpoint_prefix != nullptr && RestoreCheckpoint(session, loaded_graph, checkpoint_prefix, status) != TF_OK) {
+    DeleteSession(session);
+    TF_DeleteGraph(loaded_graph);
+    return nullptr;
+  }
+
+  *graph = loaded_graph;
+
+  return session;
 }
 
-TF_Graph* LoadGraph(const char* graph_path, TF_Status* status) {
-  return LoadGraph(graph_path, nullptr, status);
+TF_Code ConvertGraphToMemmapped(const char* graph_path, const char* model_dir, std::size_t min_tensor_bytes, TF_Status* status) {
+  if (graph_path == nullptr || model_dir == nullptr) {
+    return TF_INVALID_ARGUMENT;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto buffer = ReadGraphDef(graph_path);
+  if (buffer == nullptr) {
+    TF_SetStatus(status, TF_NOT_FOUND, "Can't read GraphDef file");
+    return TF_GetCode(status);
+  }
+  SCOPE_EXIT{ TF_DeleteBuffer(buffer); };
+
+  MakeDirectory(model_dir);
+
+  wire::Writer graph_def;
+  std::size_t num_weights = 0;
+  wire::Reader reader{buffer->data, buffer->length};
+  while (reader.Next()) {
+    NodeDef node;
+    if (reader.field() != kGraphDefNode || !ParseNodeDef(reader.data(), reader.size(), &node)) {
+      graph_def.Raw(reader.raw_data(), reader.raw_size());
+      continue;
+    }
+
+    TensorProtoView tensor;
+    auto value = FindAttr(node, "value");
+    if (node.op != "Const" || value == nullptr || !ParseTensorAttr(*value, &tensor) ||
+        tensor.dtype == TF_STRING || tensor.content_size < std::max<std::size_t>(min_tensor_bytes, 1)) {
+      graph_def.Raw(reader.raw_data(), reader.raw_size());
+      continue;
+    }
+
+    // Each weight gets its own file, which the default Env maps page aligned for ImmutableConst.
+    auto region_name = std::to_string(num_weights++) + ".weight";
+    if (!WriteFile(JoinPath(model_dir, region_name), tensor.content, tensor.content_size)) {
+      TF_SetStatus(status, TF_PERMISSION_DENIED, "Can't write weight file");
+      return TF_GetCode(status);
+    }
+
+    wire::Writer shape;
+    shape.Bytes(kAttrValueShape, tensor.shape);
+
+    node.op = "ImmutableConst";
+    RemoveAttr(&node, "value");
+    SetAttr(&node, "shape", std::move(shape.str()));
+    SetAttr(&node, "memory_region_name", AttrValueString(region_name));
+
+    graph_def.Bytes(kGraphDefNode, SerializeNodeDef(node));
+  }
+
+  if (!reader.ok()) {
+    TF_SetStatus(status, TF_DATA_LOSS, "Malformed GraphDef");
+    return TF_GetCode(status);
+  }
+
+  auto graph_def_path = JoinPath(model_dir, "graph.pb");
+  if (!WriteFile(graph_def_path, graph_def.str().data(), graph_def.str().size())) {
+    TF_SetStatus(status, TF_PERMISSION_DENIED, "Can't write GraphDef file");
+    return TF_GetCode(status);
+  }
+
+  TF_SetStatus(status, TF_OK, "");
+  return TF_OK;
+}
+
+TF_Graph* LoadMemmappedGraph(const char* model_dir, TF_Status* status) {
+  if (model_dir == nullptr) {
+    return nullptr;
+  }
+
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto dir = AbsolutePath(model_dir);
+  auto graph_def_path = JoinPath(dir, "graph.pb");
+  auto buffer = ReadBufferFromFile(graph_def_path.c_str());
+  if (buffer == nullptr) {
+    TF_SetStatus(status, TF_NOT_FOUND, ("Can't read GraphDef file " + graph_def_path).c_str());
+    return nullptr;
+  }
+  SCOPE_EXIT{ TF_DeleteBuffer(buffer); };
+
+  // Region names are stored relative to the model directory, resolve them before import.
+  wire::Writer graph_def;
+  wire::Reader reader{buffer->data, buffer->length};
+  while (reader.Next()) {
+    NodeDef node;
+    auto region_name = static_cast<const std::string*>(nullptr);
+    if (reader.field() == kGraphDefNode && ParseNodeDef(reader.data(), reader.size(), &node) &&
+        node.op == "ImmutableConst" && (region_name = FindAttr(node, "memory_region_name")) != nullptr) {
+      wire::Reader attr{*region_name};
+      if (attr.Next() && attr.field() == kAttrValueS) {
+        SetAttr(&node, "memory_region_name", AttrValueString(JoinPath(dir, attr.str())));
+      }
+      graph_def.Bytes(kGraphDefNode, SerializeNodeDef(node));
+    } else {
+      graph_def.Raw(reader.raw_data(), reader.raw_size());
+    }
+  }
+
+  if (!reader.ok()) {
+    TF_SetStatus(status, TF_DATA_LOSS, "Malformed GraphDef");
+    return nullptr;
+  }
+
+  auto graph_def_buffer = TF_NewBufferFromString(graph_def.str().data(), graph_def.str().size());
+  SCOPE_EXIT{ TF_DeleteBuffer(graph_def_buffer); };
+  graph_def.str().clear();
+
+  return ImportGraphDef(graph_def_buffer, status);
 }
 
 void DeleteGraph(TF_Graph* graph) {
@@ -179,9 +1125,37 @@ TF_Session* CreateSession(TF_Graph* graph, TF_Status* status) {
   }
 
   auto options = TF_NewSessionOptions();
+  SCOPE_EXIT{ TF_DeleteSessionOptions(options); };
+
+  auto config = DefaultSessionConfig();
+  if (!config.empty()) {
+    TF_SetConfig(options, config.data(), config.size(), status);
+    if (TF_GetCode(status) != TF_OK) {
+      return nullptr;
+    }
+  }
+
   auto session = TF_NewSession(graph, options, status);
-  TF_DeleteSessionOptions(options);
+  if (TF_GetCode(status) != TF_OK) {
+    DeleteSession(session);
+    return nullptr;
+  }
 
+  return session;
+}
+
+TF_Session* CreateSession(TF_Graph* graph, const TF_SessionOptions* options, TF_Status* status) {
+  if (graph == nullptr || options == nullptr) {
+    return nullptr;
+  }
+  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
+  if (status == nullptr) {
+    status = TF_NewStatus();
+  } else {
+    delete_status.dismiss();
+  }
+
+  auto session = TF_NewSession(graph, options, status);
   if (TF_GetCode(status) != TF_OK) {
     DeleteSession(session);
     return nullptr;
@@ -221,9 +1195,48 @@ TF_Code RunSession(TF_Session* session,
                    const TF_Output* inputs, TF_Tensor* const* input_tensors, std::size_t ninputs,
                    const TF_Output* outputs, TF_Tensor** output_tensors, std::size_t noutputs,
                    TF_Status* status) {
-  if (session == nullptr ||
-      inputs == nullptr || input_tensors == nullptr ||
-      outputs == nullptr || output_tensors == nullptr) {
+  return RunSessionWithOptions(session, nullptr,
+                               inputs, input_tensors, ninputs,
+                               outputs, output_tensors, noutputs,
+                               status);
+}
+
+TF_Code RunSession(TF_Session* session,
+                   const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                   const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+                   TF_Status* status) {
+  return RunSession(session,
+                    inputs.data(), input_tensors.data(), input_tensors.size(),
+                    outputs.data(), output_tensors.data(), output_tensors.size(),
+                    status);
+}
+
+TF_Code RunSession(TF_Session* session,
+                   const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                   const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+                   std::chrono::steady_clock::time_point deadline,
+                   TF_Status* status) {
+  // Less than a millisecond left is as good as none, and a timeout of 0 would mean no timeout at all.
+  auto timeout_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+  if (timeout_ms <= 0) {
+    if (status != nullptr) {
+      TF_SetStatus(status, TF_DEADLINE_EXCEEDED, "Deadline exceeded before the run started");
+    }
+    return TF_DEADLINE_EXCEEDED;
+  }
+
+  auto run_options = SerializeRunOptions(timeout_ms);
+  auto run_options_buffer = TF_NewBufferFromString(run_options.data(), run_options.size());
+  SCOPE_EXIT{ TF_DeleteBuffer(run_options_buffer); };
+
+  return RunSessionWithOptions(session, run_options_buffer,
+                               inputs.data(), input_tensors.data(), input_tensors.size(),
+                               outputs.data(), output_tensors.data(), output_tensors.size(),
+                               status);
+}
+
+TF_Code AbortSession(TF_Session* session, TF_Status* status) {
+  if (session == nullptr) {
     return TF_INVALID_ARGUMENT;
   }
   MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
@@ -233,29 +1246,12 @@ TF_Code RunSession(TF_Session* session,
     delete_status.dismiss();
   }
 
-
-  TF_SessionRun(session,
-                nullptr, // Run options.
-                inputs, input_tensors, static_cast<int>(ninputs), // Input tensors, input tensor values, number of inputs.
-                outputs, output_tensors, static_cast<int>(noutputs), // Output tensors, output tensor values, number of outputs.
-                nullptr, 0, // Target operations, number of targets.
-                nullptr, // Run metadata.
-                status // Output status.
-  );
+  // Closing cancels the steps in flight, the C API has no way to cancel a single TF_SessionRun.
+  TF_CloseSession(session, status);
 
   return TF_GetCode(status);
 }
 
-TF_Code RunSession(TF_Session* session,
-                   const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
-                   const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
-                   TF_Status* status) {
-  return RunSession(session,
-                    inputs.data(), input_tensors.data(), input_tensors.size(),
-                    outputs.data(), output_tensors.data(), output_tensors.size(),
-                    status);
-}
-
 TF_Tensor* CreateTensor(TF_DataType data_type,
                         const std::int64_t* dims, std::size_t num_dims,
                         const void* data, std::size_t len) {
@@ -301,6 +1297,55 @@ void DeleteTensors(const std::vector<TF_Tensor*>& tensors) {
   }
 }
 
+TF_Tensor* WrapTensor(TF_DataType data_type,
+                      const std::int64_t* dims, std::size_t num_dims,
+                      void* data, std::size_t len,
+                      TensorDeallocator deallocator, void* deallocator_arg) {
+  if (data == nullptr || (dims == nullptr && num_dims != 0) || !IsTensorAligned(data)) {
+    return nullptr;
+  }
+
+  // Types without a fixed size, such as TF_STRING, have their own encoding and aren't checked.
+  auto element_size = TF_DataTypeSize(data_type);
+  if (element_size != 0) {
+    std::size_t num_elements = 1;
+    for (std::size_t i = 0; i < num_dims; ++i) {
+      if (dims[i] < 0) {
+        return nullptr;
+      }
+      num_elements *= static_cast<std::size_t>(dims[i]);
+    }
+    if (num_elements * element_size != len) {
+      return nullptr;
+    }
+  }
+
+  return TF_NewTensor(data_type,
+                      dims, static_cast<int>(num_dims),
+                      data, len,
+                      deallocator, deallocator_arg);
+}
+
+TF_Tensor* WrapTensor(TF_DataType data_type, const std::vector<std::int64_t>& dims,
+                      void* data, std::size_t len,
+                      std::function<void()> on_release) {
+  auto callback = new std::function<void()>{std::move(on_release)};
+  auto tensor = WrapTensor(data_type, dims.data(), dims.size(), data, len,
+                           [](void*, std::size_t, void* arg) {
+                             auto on_release = static_cast<std::function<void()>*>(arg);
+                             if (*on_release) {
+                               (*on_release)();
+                             }
+                             delete on_release;
+                           },
+                           callback);
+  if (tensor == nullptr) {
+    delete callback;
+  }
+
+  return tensor;
+}
+
 void SetTensorData(TF_Tensor* tensor, const void* data, std::size_t len) {
   auto tensor_data = TF_TensorData(tensor);
   if (tensor_data != nullptr) {
@@ -310,92 +1355,27 @@ void SetTensorData(TF_Tensor* tensor, const void* data, std::size_t len) {
 
 TF_SessionOptions* CreateSessionOptions(double gpu_memory_fraction, TF_Status* status) {
   // See https://github.com/Neargye/hello_tf_c_api/issues/21 for details.
-  MAKE_SCOPE_EXIT(delete_status){ TF_DeleteStatus(status); };
-  if (status == nullptr) {
-    status = TF_NewStatus();
-  } else {
-    delete_status.dismiss();
-  }
-
-  auto options = TF_NewSessionOptions();
-
   // The following is an equivalent of setting this in Python:
   // config = tf.ConfigProto( allow_soft_placement = True )
   // config.gpu_options.allow_growth = True
   // config.gpu_options.per_process_gpu_memory_fraction = percentage
+  return SessionOptionsBuilder{}
+      .GpuMemoryFraction(gpu_memory_fraction)
+      .AllowGrowth(true)
+      .AllowSoftPlacement(true)
+      .Build(status);
+}
 
-  // Create a byte-array for the serialized ProtoConfig, set the mandatory bytes (first three and last four)
-  std::array<std::uint8_t, 15> config = {{0x32, 0xb, 0x9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x20, 0x1, 0x38, 0x1}};
-
-  // Convert the desired percentage into a byte-array.
-  auto bytes = reinterpret_cast<std::uint8_t*>(&gpu_memory_fraction);
-
-  // Put it to the config byte-array, from 3 to 10:
-  for (std::size_t i = 0; i < sizeof(gpu_memory_fraction); ++i) {
-    config[i + 3] = bytes[i];
-  }
-
-  TF_SetConfig(options, config.data(), config.size(), status);
-
-  if (TF_GetCode(status) != TF_OK) {
-    TF_DeleteSessionOptions(options);
-    return nullptr;
-  }
-
-  return options;
-}
-
-const char* DataTypeToString(TF_DataType data_type) {
-  switch (data_type) {
-    case TF_FLOAT:
-      return "TF_FLOAT";
-    case TF_DOUBLE:
-      return "TF_DOUBLE";
-    case TF_INT32:
-      return "TF_INT32";
-    case TF_UINT8:
-      return "TF_UINT8";
-    case TF_INT16:
-      return "TF_INT16";
-    case TF_INT8:
-      return "TF_INT8";
-    case TF_STRING:
-      return "TF_STRING";
-    case TF_COMPLEX64:
-      return "TF_COMPLEX64";
-    case TF_INT64:
-      return "TF_INT64";
-    case TF_BOOL:
-      return "TF_BOOL";
-    case TF_QINT8:
-      return "TF_QINT8";
-    case TF_QUINT8:
-      return "TF_QUINT8";
-    case TF_QINT32:
-      return "TF_QINT32";
-    case TF_BFLOAT16:
-      return "TF_BFLOAT16";
-    case TF_QINT16:
-      return "TF_QINT16";
-    case TF_QUINT16:
-      return "TF_QUINT16";
-    case TF_UINT16:
-      return "TF_UINT16";
-    case TF_COMPLEX128:
-      return "TF_COMPLEX128";
-    case TF_HALF:
-      return "TF_HALF";
-    case TF_RESOURCE:
-      return "TF_RESOURCE";
-    case TF_VARIANT:
-      return "TF_VARIANT";
-    case TF_UINT32:
-      return "TF_UINT32";
-    case TF_UINT64:
-      return "TF_UINT64";
-    default:
-      return "Unknown";
-  }
+TF_SessionOptions* CreateMemmappedSessionOptions(TF_Status* status) {
+  // The following is an equivalent of setting this in Python:
+  // config = tf.ConfigProto()
+  // config.graph_options.optimizer_options.opt_level = tf.OptimizerOptions.L0
+  // config.graph_options.rewrite_options.constant_folding = rewriter_config_pb2.RewriterConfig.OFF
+  // Folding would copy the mapped weights into heap constants.
+  return SessionOptionsBuilder{}
+      .OptimizerLevel(OptimizerLevel::kL0)
+      .ConstantFolding(false)
+      .Build(status);
 }
 
 const char* CodeToString(TF_Code code) {
@@ -22,30 +22,84 @@
 
 #pragma once
 
+#include "data_type.hpp"
 #include <c_api.h> // TensorFlow C API header
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-// #ifdef __cplusplus
-// extern "C" {
-// #endif
-// TF_CAPI_EXPORT extern int64_t TF_TensorElementCount(const TF_Tensor* tensor);
-// #ifdef __cplusplus
-// } /* end extern "C" */
-// #endif
-
 namespace tf_utils {
 
+// Product of the dims, the C API of TensorFlow 1.x does not export TF_TensorElementCount.
+inline std::int64_t TensorElementCount(const TF_Tensor* tensor) {
+  std::int64_t count = 1;
+  for (int i = 0, rank = TF_NumDims(tensor); i < rank; ++i) {
+    count *= TF_Dim(tensor, i);
+  }
+  return count;
+}
+
+struct PruneStats {
+  std::size_t nodes_dropped = 0;
+  std::size_t bytes_dropped = 0; // Of the serialized GraphDef.
+};
+
+struct LoadGraphOptions {
+  // Map the GraphDef file read-only instead of copying it into a heap buffer, compressed files are always read.
+  bool memory_map = false;
+  // With a checkpoint, rewrite the restored variables into Consts and re-import the frozen graph.
+  bool freeze_variables = false;
+  // Import only the nodes needed to compute `fetches` when `feeds` are fed, see PruneGraphDef.
+  std::vector<std::string> feeds;
+  std::vector<std::string> fetches;
+  // Filled in when the graph is pruned.
+  PruneStats* prune_stats = nullptr;
+};
+
+// Reads (or maps) a serialized GraphDef, delete it with TF_DeleteBuffer.
+// gzip and zstd files are detected by their magic bytes and decompressed while reading.
+TF_Buffer* ReadGraphDef(const char* graph_path, const LoadGraphOptions& options = LoadGraphOptions{});
+
+// Keeps the transitive inputs of `fetches` ("name" or "name:index"), fed nodes become Placeholders
+// and cut the graph. Feeding an op other than a Placeholder imports the whole graph once to get its
+// output type. Delete the result with TF_DeleteBuffer.
+TF_Buffer* PruneGraphDef(const TF_Buffer* graph_def,
+                         const std::vector<std::string>& feeds, const std::vector<std::string>& fetches,
+                         PruneStats* stats = nullptr, TF_Status* status = nullptr);
+
+TF_Graph* ImportGraphDef(const TF_Buffer* graph_def, TF_Status* status = nullptr);
+
+TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, const LoadGraphOptions& options, TF_Status* status = nullptr);
+
 TF_Graph* LoadGraph(const char* graph_path, const char* checkpoint_prefix, TF_Status* status = nullptr);
 
 TF_Graph* LoadGraph(const char* graph_path, TF_Status* status = nullptr);
 
+// Feeds `checkpoint_prefix` to save/Const and runs save/restore_all in `session`.
+TF_Code RestoreCheckpoint(TF_Session* session, TF_Graph* graph, const char* checkpoint_prefix, TF_Status* status = nullptr);
+
+// Loads the graph and returns a session with the checkpoint variables already restored.
+// The graph is returned through `graph`, delete it after the session.
+TF_Session* LoadSession(const char* graph_path, const char* checkpoint_prefix, TF_Graph** graph, TF_Status* status = nullptr);
+
+// Writes `model_dir`/graph.pb with every Const of at least `min_tensor_bytes` replaced by an ImmutableConst
+// that maps its weights from a file next to it, so all processes share them through the page cache.
+TF_Code ConvertGraphToMemmapped(const char* graph_path, const char* model_dir, std::size_t min_tensor_bytes = 1024, TF_Status* status = nullptr);
+
+// Loads a model written by ConvertGraphToMemmapped, use it with CreateMemmappedSessionOptions.
+TF_Graph* LoadMemmappedGraph(const char* model_dir, TF_Status* status = nullptr);
+
 void DeleteGraph(TF_Graph* graph);
 
+// Creates the session with the options of SetDefaultSessionConfig, if any.
 TF_Session* CreateSession(TF_Graph* graph, TF_Status* status = nullptr);
 
+TF_Session* CreateSession(TF_Graph* graph, const TF_SessionOptions* options, TF_Status* status = nullptr);
+
 TF_Code DeleteSession(TF_Session* session, TF_Status* status = nullptr);
 
 TF_Code RunSession(TF_Session* session,
@@ -58,56 +112,116 @@ TF_Code RunSession(TF_Session* session,
                    const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
                    TF_Status* status = nullptr);
 
+// Runs with RunOptions.timeout_in_ms set to the time left until `deadline`. TensorFlow cancels a step
+// that outlives it, and a deadline that has already passed fails without running, both with TF_DEADLINE_EXCEEDED.
+TF_Code RunSession(TF_Session* session,
+                   const std::vector<TF_Output>& inputs, const std::vector<TF_Tensor*>& input_tensors,
+                   const std::vector<TF_Output>& outputs, std::vector<TF_Tensor*>& output_tensors,
+                   std::chrono::steady_clock::time_point deadline,
+                   TF_Status* status = nullptr);
+
+// Closes the session, every run in flight on it fails with TF_CANCELLED rather than TF_DEADLINE_EXCEEDED, the
+// C API has no way to stop a run with another code. Only DeleteSession is valid afterwards.
+TF_Code AbortSession(TF_Session* session, TF_Status* status = nullptr);
+
 TF_Tensor* CreateTensor(TF_DataType data_type,
                         const std::int64_t* dims, std::size_t num_dims,
                         const void* data, std::size_t len);
 
+// Returns nullptr if T doesn't match `data_type`, see MatchesDataType. The dtype is only known at run time here,
+// so a mismatch is not a compile error as with the two overloads below.
 template <typename T>
 TF_Tensor* CreateTensor(TF_DataType data_type, const std::vector<std::int64_t>& dims, const std::vector<T>& data) {
+  if (!MatchesDataType<T>(data_type)) {
+    return nullptr;
+  }
   return CreateTensor(data_type,
                       dims.data(), dims.size(),
                       data.data(), data.size() * sizeof(T));
 }
 
+// The dtype follows from T, see DataTypeOf.
+template <typename T>
+TF_Tensor* CreateTensor(const std::vector<std::int64_t>& dims, const std::vector<T>& data) {
+  return CreateTensor(DataTypeOf<T>::value,
+                      dims.data(), dims.size(),
+                      data.data(), data.size() * sizeof(T));
+}
+
+// CreateTensor<TF_QINT8>(dims, data), T must be TypeOf<D>::type.
+template <TF_DataType D, typename T>
+TF_Tensor* CreateTensor(const std::vector<std::int64_t>& dims, const std::vector<T>& data) {
+  static_assert(std::is_same<T, typename TypeOf<D>::type>::value, "Element type doesn't match the TF_DataType");
+  return CreateTensor(D,
+                      dims.data(), dims.size(),
+                      data.data(), data.size() * sizeof(T));
+}
+
 TF_Tensor* CreateEmptyTensor(TF_DataType data_type, const std::int64_t* dims, std::size_t num_dims);
 
 TF_Tensor* CreateEmptyTensor(TF_DataType data_type, const std::vector<std::int64_t>& dims);
 
+// EIGEN_MAX_ALIGN_BYTES of the TensorFlow builds with AVX-512, TF_NewTensor copies less aligned buffers.
+constexpr std::size_t kTensorAlignment = 64;
+
+using TensorDeallocator = void (*)(void* data, std::size_t len, void* arg);
+
+// Makes a tensor over `data` without copying it. `deallocator` runs once TensorFlow drops its last reference,
+// which may be after TF_DeleteTensor if an op still holds the buffer. Returns nullptr, leaving `data` to the caller,
+// if it isn't aligned to kTensorAlignment or `len` doesn't match `dims`.
+TF_Tensor* WrapTensor(TF_DataType data_type,
+                      const std::int64_t* dims, std::size_t num_dims,
+                      void* data, std::size_t len,
+                      TensorDeallocator deallocator, void* deallocator_arg);
+
+// Same with a callback, e.g. one that returns the buffer to its owner or keeps it alive through a capture.
+TF_Tensor* WrapTensor(TF_DataType data_type, const std::vector<std::int64_t>& dims,
+                      void* data, std::size_t len,
+                      std::function<void()> on_release);
+
+inline bool IsTensorAligned(const void* data) {
+  return reinterpret_cast<std::uintptr_t>(data) % kTensorAlignment == 0;
+}
+
 void DeleteTensor(TF_Tensor* tensor);
 
 void DeleteTensors(const std::vector<TF_Tensor*>& tensors);
 
 void SetTensorData(TF_Tensor* tensor, const void* data, std::size_t len);
 
+// Does nothing if the elements of T aren't the size of the tensor's dtype.
 template <typename T>
 void SetTensorData(TF_Tensor* tensor, const std::vector<T>& data) {
-  SetTensorsData(tensor, data.data(), data.size() * sizeof(T));
+  if (MatchesDataType<T>(TF_TensorType(tensor))) {
+    SetTensorData(tensor, data.data(), data.size() * sizeof(T));
+  }
 }
 
-// template <typename T>
-// std::vector<T> GetTensorData(const TF_Tensor* tensor) {
-//   auto data = static_cast<T*>(TF_TensorData(tensor));
-//   if (data == nullptr) {
-//     return {};
-//   }
-
-//   return {data, data + TF_TensorElementCount(tensor)};
-// }
+// Copies of the elements, tf_utils::Tensor<T> (tensor.hpp) reads them in place.
+template <typename T>
+std::vector<T> GetTensorData(const TF_Tensor* tensor) {
+  auto data = static_cast<T*>(TF_TensorData(tensor));
+  if (data == nullptr) {
+    return {};
+  }
 
-// template <typename T>
-// std::vector<std::vector<T>> GetTensorsData(const std::vector<TF_Tensor*>& tensors) {
-//   std::vector<std::vector<T>> data;
-//   data.reserve(tensors.size());
-//   for (auto t : tensors) {
-//     data.push_back(GetTensorData<T>(t));
-//   }
+  return {data, data + TensorElementCount(tensor)};
+}
 
-//   return data;
-// }
+template <typename T>
+std::vector<std::vector<T>> GetTensorsData(const std::vector<TF_Tensor*>& tensors) {
+  std::vector<std::vector<T>> data;
+  data.reserve(tensors.size());
+  for (auto t : tensors) {
+    data.push_back(GetTensorData<T>(t));
+  }
+
+  return data;
+}
 
 TF_SessionOptions* CreateSessionOptions(double gpu_memory_fraction, TF_Status* status = nullptr);
 
-const char* DataTypeToString(TF_DataType data_type);
+TF_SessionOptions* CreateMemmappedSessionOptions(TF_Status* status = nullptr);
 
 const char* CodeToString(TF_Code code);
 
@@ -0,0 +1,170 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "model_registry.hpp"
+#include "session_options.hpp"
+#include <scope_guard.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Usage: thread_pools_benchmark [graph.pb] [num_models] [pool_threads] [runs]
+
+static int ThreadCount() {
+#if defined(__linux__)
+  std::ifstream f("/proc/self/status");
+  std::string line;
+  while (std::getline(f, line)) {
+    if (line.compare(0, 8, "Threads:") == 0) {
+      return std::atoi(line.c_str() + 8);
+    }
+  }
+#endif
+  return -1;
+}
+
+// Every model is served by its own client thread, returns the latencies of all runs in milliseconds.
+static std::vector<double> Benchmark(const std::vector<tf_utils::SessionHandle>& sessions, TF_Graph* graph, int runs, int* threads) {
+  const std::vector<std::int64_t> input_dims = {1, 5, 12};
+  const std::vector<float> input_vals(60, 0.5f);
+  const std::vector<TF_Output> input_ops = {{TF_GraphOperationByName(graph, "input_4"), 0}};
+  const std::vector<TF_Output> out_ops = {{TF_GraphOperationByName(graph, "output_node0"), 0}};
+
+  std::vector<std::vector<double>> latencies(sessions.size());
+  std::vector<std::thread> clients;
+  for (std::size_t i = 0; i < sessions.size(); ++i) {
+    clients.emplace_back([&, i] {
+      const std::vector<TF_Tensor*> input_tensors = {tf_utils::CreateTensor(TF_FLOAT, input_dims, input_vals)};
+      SCOPE_EXIT{ tf_utils::DeleteTensors(input_tensors); };
+
+      for (int r = 0; r < runs; ++r) {
+        std::vector<TF_Tensor*> output_tensors = {nullptr};
+        SCOPE_EXIT{ tf_utils::DeleteTensors(output_tensors); };
+
+        auto start = std::chrono::steady_clock::now();
+        if (tf_utils::RunSession(sessions[i].get(), input_ops, input_tensors, out_ops, output_tensors) != TF_OK) {
+          return;
+        }
+        auto stop = std::chrono::steady_clock::now();
+        latencies[i].push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+      }
+    });
+  }
+
+  // Sample while the clients run, TensorFlow starts pool threads lazily.
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  *threads = ThreadCount();
+  for (auto& c : clients) {
+    c.join();
+  }
+
+  std::vector<double> all;
+  for (auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+  return all;
+}
+
+static void PrintLatencies(const char* name, const std::vector<double>& latencies, int threads) {
+  if (latencies.empty()) {
+    std::cout << name << ": threads " << threads << ", no runs" << std::endl;
+    return;
+  }
+  auto percentile = [&latencies](double p) {
+    return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+  };
+  std::cout << name << ": threads " << threads
+            << ", p50 " << percentile(0.5) << " ms, p99 " << percentile(0.99) << " ms, max " << latencies.back() << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  auto graph_path = argc > 1 ? argv[1] : "graph.pb";
+  auto num_models = static_cast<std::size_t>(argc > 2 ? std::atoi(argv[2]) : 8);
+  auto pool_threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+  auto runs = argc > 4 ? std::atoi(argv[4]) : 100;
+
+  auto status = TF_NewStatus();
+  SCOPE_EXIT{ TF_DeleteStatus(status); };
+
+  auto graph = tf_utils::ModelRegistry::Instance().GetGraph(graph_path, status);
+  if (graph == nullptr) {
+    std::cout << "Can't load graph: " << TF_Message(status) << std::endl;
+    return 1;
+  }
+
+  std::vector<double> per_session_latencies;
+  int per_session_threads = 0;
+  {
+    // Each session starts its own inter-op pool.
+    auto options = tf_utils::SessionOptionsBuilder{}
+        .InterOpParallelismThreads(pool_threads)
+        .UsePerSessionThreads(true)
+        .Build(status);
+    SCOPE_EXIT{ TF_DeleteSessionOptions(options); };
+
+    std::vector<tf_utils::SessionHandle> sessions;
+    for (std::size_t i = 0; i < num_models && options != nullptr; ++i) {
+      sessions.push_back(tf_utils::CreateSession(graph, options, status));
+    }
+    if (options == nullptr || std::count(sessions.begin(), sessions.end(), nullptr) != 0) {
+      std::cout << "Can't create session: " << TF_Message(status) << std::endl;
+      return 1;
+    }
+    per_session_latencies = Benchmark(sessions, graph.get(), runs, &per_session_threads);
+  }
+
+  std::vector<double> shared_latencies;
+  int shared_threads = 0;
+  {
+    // Every session created by tf_utils without explicit options runs on the one named pool.
+    tf_utils::SetDefaultSessionConfig(tf_utils::SessionOptionsBuilder{}.SessionInterOpThreadPool(pool_threads, "shared").Serialize());
+    SCOPE_EXIT{ tf_utils::SetDefaultSessionConfig({}); };
+
+    std::vector<tf_utils::SessionHandle> sessions;
+    for (std::size_t i = 0; i < num_models; ++i) {
+      sessions.push_back(tf_utils::CreateSession(graph, nullptr, status));
+    }
+    if (std::count(sessions.begin(), sessions.end(), nullptr) != 0) {
+      std::cout << "Can't create session: " << TF_Message(status) << std::endl;
+      return 1;
+    }
+    shared_latencies = Benchmark(sessions, graph.get(), runs, &shared_threads);
+  }
+
+  auto expected = num_models * static_cast<std::size_t>(runs);
+  if (per_session_latencies.size() != expected || shared_latencies.size() != expected) {
+    std::cout << "Error run session" << std::endl;
+    return 1;
+  }
+
+  std::cout << num_models << " models, " << pool_threads << " pool threads, " << runs << " runs per model" << std::endl;
+  PrintLatencies("Per-session pools", per_session_latencies, per_session_threads);
+  PrintLatencies("Shared pool", shared_latencies, shared_threads);
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "wire_format.hpp"
+#include <cstring>
+
+namespace tf_utils {
+
+namespace wire {
+
+Reader::Reader(const void* data, std::size_t size)
+    : pos_{static_cast<const char*>(data)},
+      end_{static_cast<const char*>(data) + size} {
+}
+
+Reader::Reader(const std::string& message) : Reader{message.data(), message.size()} {
+}
+
+bool Reader::ReadVarint(std::uint64_t* value) {
+  *value = 0;
+  for (std::uint32_t shift = 0; shift < 64; shift += 7) {
+    if (pos_ >= end_) {
+      return false;
+    }
+    auto byte = static_cast<std::uint8_t>(*pos_++);
+    *value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Reader::Next() {
+  if (!ok_ || pos_ >= end_) {
+    return false;
+  }
+
+  field_begin_ = pos_;
+  std::uint64_t tag = 0;
+  if (!ReadVarint(&tag) || (tag >> 3) == 0) {
+    ok_ = false;
+    return false;
+  }
+  field_ = static_cast<std::uint32_t>(tag >> 3);
+  type_ = static_cast<WireType>(tag & 0x7);
+  data_ = nullptr;
+  size_ = 0;
+
+  switch (type_) {
+    case kVarint:
+      ok_ = ReadVarint(&value_);
+      break;
+    case kFixed64:
+    case kFixed32: {
+      auto n = type_ == kFixed64 ? std::size_t{8} : std::size_t{4};
+      if (static_cast<std::size_t>(end_ - pos_) < n) {
+        ok_ = false;
+        break;
+      }
+      value_ = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        value_ |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(pos_[i])) << (8 * i);
+      }
+      pos_ += n;
+      break;
+    }
+    case kLengthDelimited: {
+      std::uint64_t size = 0;
+      if (!ReadVarint(&size) || size > static_cast<std::uint64_t>(end_ - pos_)) {
+        ok_ = false;
+        break;
+      }
+      data_ = pos_;
+      size_ = static_cast<std::size_t>(size);
+      value_ = size;
+      pos_ += size_;
+      break;
+    }
+    default: // Groups are deprecated and never used by TensorFlow protos.
+      ok_ = false;
+      break;
+  }
+
+  return ok_;
+}
+
+void Writer::WriteVarint(std::uint64_t value) {
+  while (value >= 0x80) {
+    buffer_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  buffer_.push_back(static_cast<char>(value));
+}
+
+void Writer::Tag(std::uint32_t field, WireType type) {
+  WriteVarint((static_cast<std::uint64_t>(field) << 3) | type);
+}
+
+void Writer::Varint(std::uint32_t field, std::uint64_t value) {
+  Tag(field, kVarint);
+  WriteVarint(value);
+}
+
+void Writer::Fixed64(std::uint32_t field, std::uint64_t value) {
+  Tag(field, kFixed64);
+  for (std::size_t i = 0; i < 8; ++i) {
+    buffer_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+void Writer::Double(std::uint32_t field, double value) {
+  static_assert(sizeof(double) == sizeof(std::uint64_t), "double must be 64-bit");
+  std::uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  Fixed64(field, bits);
+}
+
+void Writer::Bytes(std::uint32_t field, const void* data, std::size_t size) {
+  Tag(field, kLengthDelimited);
+  WriteVarint(size);
+  Raw(data, size);
+}
+
+void Writer::Raw(const void* data, std::size_t size) {
+  buffer_.append(static_cast<const char*>(data), size);
+}
+
+} // namespace tf_utils::wire
+
+} // namespace tf_utils
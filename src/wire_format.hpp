@@ -0,0 +1,122 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Minimal protocol buffers wire format reader/writer, enough to inspect and
+// rewrite GraphDef/ConfigProto messages without linking libprotobuf.
+// See https://developers.google.com/protocol-buffers/docs/encoding for details.
+
+namespace tf_utils {
+
+namespace wire {
+
+enum WireType : std::uint32_t {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kFixed32 = 5,
+};
+
+class Reader {
+ public:
+  Reader(const void* data, std::size_t size);
+
+  explicit Reader(const std::string& message);
+
+  // Advances to the next field. Returns false at the end of the message or on malformed input.
+  bool Next();
+
+  // False if the message was malformed.
+  bool ok() const { return ok_; }
+
+  std::uint32_t field() const { return field_; }
+
+  WireType type() const { return type_; }
+
+  // Value of a varint, fixed64 or fixed32 field.
+  std::uint64_t value() const { return value_; }
+
+  // Payload of a length-delimited field.
+  const char* data() const { return data_; }
+
+  std::size_t size() const { return size_; }
+
+  std::string str() const { return {data_, size_}; }
+
+  // Whole current field including its tag, for copying it through unchanged.
+  const char* raw_data() const { return field_begin_; }
+
+  std::size_t raw_size() const { return static_cast<std::size_t>(pos_ - field_begin_); }
+
+ private:
+  bool ReadVarint(std::uint64_t* value);
+
+  const char* pos_;
+  const char* end_;
+  const char* field_begin_ = nullptr;
+  bool ok_ = true;
+  std::uint32_t field_ = 0;
+  WireType type_ = kVarint;
+  std::uint64_t value_ = 0;
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+class Writer {
+ public:
+  void Varint(std::uint32_t field, std::uint64_t value);
+
+  void Int64(std::uint32_t field, std::int64_t value) { Varint(field, static_cast<std::uint64_t>(value)); }
+
+  void Bool(std::uint32_t field, bool value) { Varint(field, value ? 1 : 0); }
+
+  void Fixed64(std::uint32_t field, std::uint64_t value);
+
+  void Double(std::uint32_t field, double value);
+
+  void Bytes(std::uint32_t field, const void* data, std::size_t size);
+
+  void Bytes(std::uint32_t field, const std::string& data) { Bytes(field, data.data(), data.size()); }
+
+  // Appends already encoded bytes, e.g. Reader::raw_data() of a field kept as is.
+  void Raw(const void* data, std::size_t size);
+
+  const std::string& str() const { return buffer_; }
+
+  std::string& str() { return buffer_; }
+
+ private:
+  void Tag(std::uint32_t field, WireType type);
+
+  void WriteVarint(std::uint64_t value);
+
+  std::string buffer_;
+};
+
+} // namespace tf_utils::wire
+
+} // namespace tf_utils
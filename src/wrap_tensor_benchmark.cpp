@@ -0,0 +1,117 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2018 - 2019 Daniil Goncharov <neargye@gmail.com>.
+//
+// Permission is hereby  granted, free of charge, to any  person obtaining a copy
+// of this software and associated  documentation files (the "Software"), to deal
+// in the Software  without restriction, including without  limitation the rights
+// to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+// copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tf_utils.hpp"
+#include <scope_guard.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Usage: wrap_tensor_benchmark [iterations]
+
+static void* AlignedAlloc(std::size_t len) {
+  void* data = nullptr;
+  if (posix_memalign(&data, tf_utils::kTensorAlignment, len) != 0) {
+    return nullptr;
+  }
+  return data;
+}
+
+static void KeepBuffer(void*, std::size_t, void*) {}
+
+// Time per tensor of `make`, create and delete included.
+template <typename F>
+static double Measure(int iterations, F&& make) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    auto tensor = make();
+    if (tensor == nullptr) {
+      return -1.0;
+    }
+    TF_DeleteTensor(tensor);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(stop - start).count() / iterations;
+}
+
+static bool Compare(const char* name, TF_DataType data_type, const std::vector<std::int64_t>& dims, int iterations) {
+  std::size_t len = TF_DataTypeSize(data_type);
+  for (auto d : dims) {
+    len *= static_cast<std::size_t>(d);
+  }
+  auto data = AlignedAlloc(len);
+  SCOPE_EXIT{ std::free(data); };
+  if (data == nullptr) {
+    return false;
+  }
+  std::memset(data, 1, len);
+
+  auto copied = Measure(iterations, [&] {
+    return tf_utils::CreateTensor(data_type, dims.data(), dims.size(), data, len);
+  });
+  auto wrapped = Measure(iterations, [&] {
+    return tf_utils::WrapTensor(data_type, dims.data(), dims.size(), data, len, KeepBuffer, nullptr);
+  });
+  if (copied < 0.0 || wrapped < 0.0) {
+    std::cout << "Can't create tensor" << std::endl;
+    return false;
+  }
+
+  std::cout << name << " (" << len << " bytes): CreateTensor " << copied << " us, WrapTensor " << wrapped << " us" << std::endl;
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+  // The tensor must use the caller's buffer, and a misaligned one must be refused rather than copied.
+  const std::vector<std::int64_t> dims = {1, 5, 12};
+  const std::size_t len = 60 * sizeof(float);
+  auto data = static_cast<char*>(AlignedAlloc(len + tf_utils::kTensorAlignment));
+  SCOPE_EXIT{ std::free(data); };
+  bool released = false;
+  auto tensor = tf_utils::WrapTensor(TF_FLOAT, dims, data, len, [&released] { released = true; });
+  if (tensor == nullptr || TF_TensorData(tensor) != data) {
+    std::cout << "Wrapped tensor does not share the buffer" << std::endl;
+    return 1;
+  }
+  TF_DeleteTensor(tensor);
+  if (!released) {
+    std::cout << "Release callback was not called" << std::endl;
+    return 2;
+  }
+  if (tf_utils::WrapTensor(TF_FLOAT, dims.data(), dims.size(), data + 4, len, KeepBuffer, nullptr) != nullptr ||
+      tf_utils::WrapTensor(TF_FLOAT, dims.data(), dims.size(), data, len - 4, KeepBuffer, nullptr) != nullptr) {
+    std::cout << "Misaligned or short buffer is not refused" << std::endl;
+    return 3;
+  }
+
+  if (!Compare("Input features {1, 5, 12}", TF_FLOAT, dims, iterations) ||
+      !Compare("Deeplab frame {1, 288, 512, 3}", TF_UINT8, {1, 288, 512, 3}, iterations) ||
+      !Compare("Feature batch {256, 1024}", TF_FLOAT, {256, 1024}, iterations)) {
+    return 4;
+  }
+
+  return 0;
+}
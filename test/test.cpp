@@ -33,11 +33,255 @@
 #endif
 
 #include <c_api.h> // TensorFlow C API header
+#include "data_type.hpp"
+#include "model_signature.hpp"
+#include "session_options.hpp"
+#include "tensor.hpp"
+#include "wire_format.hpp"
 
 #if defined(_MSC_VER)
 #  pragma warning(pop)
 #endif
 
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
 TEST_CASE("Hello TF C API") {
   REQUIRE(std::string(TF_Version()) == std::string("1.14.0"));
 }
+
+// Field number to value of every varint/fixed64 field and to payload of every length-delimited field.
+struct DecodedMessage {
+  std::map<std::uint32_t, std::uint64_t> values;
+  std::map<std::uint32_t, std::string> messages;
+  bool ok = false;
+};
+
+static DecodedMessage Decode(const std::string& message) {
+  DecodedMessage decoded;
+  tf_utils::wire::Reader reader{message};
+  while (reader.Next()) {
+    if (reader.type() == tf_utils::wire::kLengthDelimited) {
+      decoded.messages[reader.field()] = reader.str();
+    } else {
+      decoded.values[reader.field()] = reader.value();
+    }
+  }
+  decoded.ok = reader.ok();
+  return decoded;
+}
+
+static double ToDouble(std::uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+TEST_CASE("SessionOptionsBuilder") {
+  SECTION("Empty config") {
+    REQUIRE(tf_utils::SessionOptionsBuilder{}.Serialize().empty());
+  }
+
+  SECTION("Matches the former hand-encoded GPU config") {
+    const std::uint8_t expected[] = {0x32, 0xb, 0x9, 0x9A, 0x99, 0x99, 0x99, 0x99, 0x99, 0xD9, 0x3F, 0x20, 0x1, 0x38, 0x1};
+    auto config = tf_utils::SessionOptionsBuilder{}.GpuMemoryFraction(0.4).AllowGrowth(true).AllowSoftPlacement(true).Serialize();
+    REQUIRE(config == std::string(reinterpret_cast<const char*>(expected), sizeof(expected)));
+  }
+
+  SECTION("Round-trips CPU thread pool options") {
+    auto config = tf_utils::SessionOptionsBuilder{}
+        .DeviceCount("GPU", 0)
+        .IntraOpParallelismThreads(4)
+        .InterOpParallelismThreads(2)
+        .UsePerSessionThreads(true)
+        .AllowSoftPlacement(false)
+        .OperationTimeoutInMs(1500)
+        .Serialize();
+
+    auto decoded = Decode(config);
+    REQUIRE(decoded.ok);
+    REQUIRE(decoded.values.at(tf_utils::kConfigIntraOpParallelismThreads) == 4);
+    REQUIRE(decoded.values.at(tf_utils::kConfigInterOpParallelismThreads) == 2);
+    REQUIRE(decoded.values.at(tf_utils::kConfigUsePerSessionThreads) == 1);
+    REQUIRE(decoded.values.at(tf_utils::kConfigAllowSoftPlacement) == 0);
+    REQUIRE(decoded.values.at(tf_utils::kConfigOperationTimeoutInMs) == 1500);
+    REQUIRE(decoded.messages.count(tf_utils::kConfigGpuOptions) == 0);
+    REQUIRE(decoded.messages.count(tf_utils::kConfigGraphOptions) == 0);
+
+    auto device_count = Decode(decoded.messages.at(tf_utils::kConfigDeviceCount));
+    REQUIRE(device_count.messages.at(1) == "GPU");
+    REQUIRE(device_count.values.count(2) == 1);
+    REQUIRE(device_count.values.at(2) == 0);
+  }
+
+  SECTION("Round-trips GPU options") {
+    auto config = tf_utils::SessionOptionsBuilder{}.GpuMemoryFraction(0.25).Serialize();
+
+    auto gpu_options = Decode(Decode(config).messages.at(tf_utils::kConfigGpuOptions));
+    REQUIRE(gpu_options.ok);
+    REQUIRE(ToDouble(gpu_options.values.at(tf_utils::kGpuOptionsPerProcessGpuMemoryFraction)) == 0.25);
+    REQUIRE(gpu_options.values.count(tf_utils::kGpuOptionsAllowGrowth) == 0);
+  }
+
+  SECTION("Round-trips graph optimizer options") {
+    auto config = tf_utils::SessionOptionsBuilder{}
+        .OptimizerLevel(tf_utils::OptimizerLevel::kL0)
+        .ConstantFolding(false)
+        .Serialize();
+
+    auto graph_options = Decode(Decode(config).messages.at(tf_utils::kConfigGraphOptions));
+    REQUIRE(graph_options.ok);
+    auto optimizer_options = Decode(graph_options.messages.at(tf_utils::kGraphOptionsOptimizerOptions));
+    REQUIRE(static_cast<std::int64_t>(optimizer_options.values.at(tf_utils::kOptimizerOptionsOptLevel)) == -1);
+    auto rewrite_options = Decode(graph_options.messages.at(tf_utils::kGraphOptionsRewriteOptions));
+    REQUIRE(rewrite_options.values.at(tf_utils::kRewriterConfigConstantFolding) == 2); // OFF
+  }
+
+  SECTION("Round-trips session inter-op thread pools") {
+    auto config = tf_utils::SessionOptionsBuilder{}
+        .SessionInterOpThreadPool(8, "shared")
+        .SessionInterOpThreadPool(2)
+        .Serialize();
+
+    std::vector<std::string> pools;
+    tf_utils::wire::Reader reader{config};
+    while (reader.Next()) {
+      REQUIRE(reader.field() == tf_utils::kConfigSessionInterOpThreadPool);
+      pools.push_back(reader.str());
+    }
+    REQUIRE(reader.ok());
+    REQUIRE(pools.size() == 2);
+
+    auto shared = Decode(pools[0]);
+    REQUIRE(shared.values.at(tf_utils::kThreadPoolOptionNumThreads) == 8);
+    REQUIRE(shared.messages.at(tf_utils::kThreadPoolOptionGlobalName) == "shared");
+    auto own = Decode(pools[1]);
+    REQUIRE(own.values.at(tf_utils::kThreadPoolOptionNumThreads) == 2);
+    REQUIRE(own.messages.count(tf_utils::kThreadPoolOptionGlobalName) == 0);
+  }
+
+  SECTION("Builds session options") {
+    auto status = TF_NewStatus();
+    auto options = tf_utils::SessionOptionsBuilder{}.IntraOpParallelismThreads(1).InterOpParallelismThreads(1).Build(status);
+    REQUIRE(TF_GetCode(status) == TF_OK);
+    REQUIRE(options != nullptr);
+    TF_DeleteSessionOptions(options);
+    TF_DeleteStatus(status);
+  }
+}
+
+TEST_CASE("SerializeRunOptions") {
+  REQUIRE(tf_utils::SerializeRunOptions(0).empty());
+
+  auto run_options = Decode(tf_utils::SerializeRunOptions(250));
+  REQUIRE(run_options.ok);
+  REQUIRE(run_options.values.at(tf_utils::kRunOptionsTimeoutInMs) == 250);
+}
+
+TEST_CASE("Tensor") {
+  const std::int64_t dims[] = {2, 3};
+  tf_utils::Tensor<float> tensor{TF_AllocateTensor(TF_FLOAT, dims, 2, 6 * sizeof(float))};
+  REQUIRE(tensor);
+  REQUIRE(tensor.rank() == 2);
+  REQUIRE(tensor.shape() == std::vector<std::int64_t>{2, 3});
+  REQUIRE(tensor.size() == 6);
+
+  SECTION("Views the tensor's own buffer") {
+    for (std::int64_t i = 0; i < 2; ++i) {
+      for (std::int64_t j = 0; j < 3; ++j) {
+        tensor(i, j) = static_cast<float>(i * 10 + j);
+      }
+    }
+    auto data = tensor.data();
+    REQUIRE(data.data() == TF_TensorData(tensor.get()));
+    REQUIRE(data[4] == 11.0f);
+    REQUIRE_THROWS_AS(data.at(6), std::out_of_range);
+  }
+
+  SECTION("Moves ownership") {
+    auto raw = tensor.get();
+    auto moved = std::move(tensor);
+    REQUIRE_FALSE(tensor);
+    REQUIRE(tensor.size() == 0);
+    REQUIRE(moved.get() == raw);
+
+    std::vector<TF_Tensor*> outputs = {moved.release()};
+    auto owned = tf_utils::TakeTensors<float>(outputs);
+    REQUIRE(outputs[0] == nullptr);
+    REQUIRE(owned[0].get() == raw);
+  }
+}
+
+TEST_CASE("DataType") {
+  static_assert(tf_utils::DataTypeOf<float>::value == TF_FLOAT, "");
+  static_assert(tf_utils::DataTypeOf<std::complex<double>>::value == TF_COMPLEX128, "");
+  static_assert(std::is_same<tf_utils::TypeOf<TF_QUINT8>::type, std::uint8_t>::value, "");
+  static_assert(tf_utils::DataTypeSize(TF_HALF) == sizeof(tf_utils::Half), "");
+  static_assert(tf_utils::DataTypeSize(TF_STRING) == 0, "");
+  static_assert(!tf_utils::MatchesDataType<double>(TF_FLOAT), "");
+  static_assert(!tf_utils::MatchesDataType<std::int32_t>(TF_FLOAT), "");
+  static_assert(tf_utils::MatchesDataType<std::uint8_t>(TF_QUINT8), "");
+  static_assert(tf_utils::MatchesDataType<char>(TF_INT8), "");
+  static_assert(tf_utils::MatchesDataType<std::uint8_t>(TF_STRING), "");
+  static_assert(tf_utils::MatchesDataType<char>(TF_STRING), "");
+  static_assert(tf_utils::MatchesDataType<std::uint16_t>(TF_HALF), "");
+  static_assert(tf_utils::MatchesDataType<std::uint16_t>(TF_BFLOAT16), "");
+  static_assert(!tf_utils::MatchesDataType<std::int16_t>(TF_HALF), "");
+
+  for (int i = TF_FLOAT; i <= TF_UINT64; ++i) {
+    const auto data_type = static_cast<TF_DataType>(i);
+    REQUIRE(tf_utils::DataTypeSize(data_type) == TF_DataTypeSize(data_type));
+  }
+  REQUIRE(std::string{tf_utils::DataTypeToString(TF_BFLOAT16)} == "TF_BFLOAT16");
+  REQUIRE(std::string{tf_utils::DataTypeToString(static_cast<TF_DataType>(42))} == "Unknown");
+
+  SECTION("Half") {
+    REQUIRE(tf_utils::Half{1.0f}.bits == 0x3c00);
+    REQUIRE(tf_utils::Half{-2.0f}.bits == 0xc000);
+    REQUIRE(tf_utils::Half{65504.0f}.bits == 0x7bff);
+    REQUIRE(tf_utils::Half{1e6f}.bits == 0x7c00);
+    REQUIRE(tf_utils::Half{5.9604645e-08f}.bits == 0x0001);
+    REQUIRE(tf_utils::Half{1.00048828125f}.bits == 0x3c00); // Tie rounds to even.
+    for (float v : {0.0f, 0.5f, -3.25f, 1024.0f, 6.1035156e-05f, 5.9604645e-08f}) {
+      REQUIRE(static_cast<float>(tf_utils::Half{v}) == v);
+    }
+  }
+
+  SECTION("BFloat16") {
+    REQUIRE(tf_utils::BFloat16{1.0f}.bits == 0x3f80);
+    REQUIRE(tf_utils::BFloat16{1.00390625f}.bits == 0x3f80); // Tie rounds to even.
+    REQUIRE(static_cast<float>(tf_utils::BFloat16{-0.15625f}) == -0.15625f);
+  }
+}
+
+TEST_CASE("ModelSignature without inputs") {
+  auto status = TF_NewStatus();
+  auto graph = TF_NewGraph();
+
+  const std::vector<float> value = {2.5f};
+  auto value_tensor = tf_utils::CreateTensor({1}, value);
+  auto desc = TF_NewOperation(graph, "Const", "value");
+  TF_SetAttrType(desc, "dtype", TF_FLOAT);
+  TF_SetAttrTensor(desc, "value", value_tensor, status);
+  TF_FinishOperation(desc, status);
+  tf_utils::DeleteTensor(value_tensor);
+  REQUIRE(TF_GetCode(status) == TF_OK);
+
+  tf_utils::ModelSignature signature;
+  REQUIRE(signature.Bind(graph, {}, {"value"}, status) == TF_OK);
+
+  auto session = tf_utils::CreateSession(graph, status);
+  REQUIRE(session != nullptr);
+
+  std::vector<TF_Tensor*> output_tensors;
+  REQUIRE(signature.Run(session, {}, output_tensors, status) == TF_OK);
+  REQUIRE(tf_utils::GetTensorData<float>(output_tensors.at(0)) == value);
+
+  tf_utils::DeleteTensors(output_tensors);
+  tf_utils::DeleteSession(session);
+  tf_utils::DeleteGraph(graph);
+  TF_DeleteStatus(status);
+}